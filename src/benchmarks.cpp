@@ -0,0 +1,325 @@
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <cctype>
+#include <thread>
+#include <algorithm>
+#include "filereader.h"
+#include "exceptions.h"
+#include "student.h"
+#include "course.h"
+#include "nameindex.h"
+#include "ranking.h"
+#include "filewriter.h"
+#include "gzipblock.h"
+
+// Function prototypes
+std::vector<std::string> split(const std::string& str, char delimiter);
+std::string trim(const std::string& str);
+
+// Live heap bytes, counted through the global allocation functions
+static std::atomic<size_t> liveBytes(0);
+static std::atomic<size_t> allocationCount(0);
+
+static const size_t HEADER = sizeof(std::max_align_t);
+
+void* operator new(size_t size) {
+    void* block = std::malloc(size + HEADER);
+    if (!block) throw std::bad_alloc();
+    *static_cast<size_t*>(block) = size;
+    liveBytes += size;
+    allocationCount++;
+    return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(block) + HEADER);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    void* block = reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(pointer) - HEADER);
+    liveBytes -= *static_cast<size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+// Validation messages go to std::cout; keep them out of the timings
+class QuietOutput {
+    private:
+        std::streambuf* savedOut;
+        std::streambuf* savedErr;
+
+    public:
+        QuietOutput() : savedOut(std::cout.rdbuf(nullptr)), savedErr(std::cerr.rdbuf(nullptr)) {}
+        ~QuietOutput() {
+            std::cout.rdbuf(savedOut);
+            std::cerr.rdbuf(savedErr);
+        }
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Synthetic feed: studentCount students with 1-7 courses each (median 4)
+static size_t writeFeed(const std::string& names, const std::string& courses, size_t studentCount) {
+    std::mt19937 random(317);
+    std::ofstream nameFile(names), courseFile(courses);
+    const char* prefixes[] = {"CP", "MA", "BU", "ST", "PS"};
+    size_t rows = 0;
+    for (size_t i = 0; i < studentCount; ++i) {
+        std::string id = std::to_string(100000000 + i * 7919 % 900000000);
+        nameFile << id << ", Student " << i << "\n";
+        int courseCount = 1 + random() % 7;
+        for (int c = 0; c < courseCount; ++c) {
+            courseFile << id << ", " << prefixes[c % 5] << (100 + c * 37 + i % 13) << ", "
+                       << random() % 101 << ", " << random() % 101 << ", "
+                       << random() % 101 << ", " << random() % 101 << "\n";
+            rows++;
+        }
+    }
+    return rows;
+}
+
+void benchIngest(size_t studentCount){
+    std::cout<<"--------BENCHMARK: INGEST ("<<studentCount<<" students)--------"<<std::endl;
+    size_t rows = writeFeed("bench_names.txt", "bench_courses.txt", studentCount);
+
+    size_t heapBefore = liveBytes;
+    size_t allocationsBefore = allocationCount;
+    double seconds;
+    std::map<std::string, Student> students;
+    {
+        QuietOutput quiet;
+        auto start = std::chrono::steady_clock::now();
+        FileReader nameFile ("bench_names.txt");
+        nameFile.readNameFile(students);
+        FileReader courseFile ("bench_courses.txt");
+        courseFile.readCourseFile(students);
+        seconds = secondsSince(start);
+    }
+    size_t heapBytes = liveBytes - heapBefore;
+
+    std::cout<<"Course rows:             "<<rows<<std::endl;
+    std::cout<<"Load time:               "<<seconds<<" s ("<<rows / seconds<<" rows/sec)"<<std::endl;
+    std::cout<<"Allocations during load: "<<allocationCount - allocationsBefore<<std::endl;
+    std::cout<<"sizeof(Student):         "<<sizeof(Student)<<" bytes"<<std::endl;
+    std::cout<<"Heap per student:        "<<static_cast<double>(heapBytes) / students.size()<<" bytes"<<std::endl;
+    std::cout<<"\n";
+
+    std::remove("bench_names.txt");
+    std::remove("bench_courses.txt");
+}
+// Synthetic two-part names from a syllable pool; real rosters repeat names too
+static std::string makeName(std::mt19937& random) {
+    const char* syllables[] = {"an", "bel", "cor", "da", "el", "fin", "gar", "hol", "is", "jo",
+                               "ka", "lin", "mo", "nor", "os", "pa", "ri", "sol", "ta", "ver"};
+    std::string name;
+    for (int part = 0; part < 2; ++part) {
+        int count = 2 + random() % 2;
+        std::string word;
+        for (int i = 0; i < count; ++i) {
+            word += syllables[random() % 20];
+        }
+        word[0] = static_cast<char>(std::toupper(word[0]));
+        name += (part ? " " : "") + word;
+    }
+    return name;
+}
+
+void benchNameSearch(size_t studentCount){
+    std::cout<<"--------BENCHMARK: NAME SEARCH ("<<studentCount<<" students)--------"<<std::endl;
+    std::mt19937 random(317);
+    std::vector<std::pair<std::string, std::string>> roster;
+    roster.reserve(studentCount);
+    for (size_t i = 0; i < studentCount; ++i) {
+        roster.emplace_back(std::to_string(100000000 + i), makeName(random));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    NameIndex index;
+    for (const auto& [id, name] : roster) {
+        index.add(id, name);
+    }
+    index.build();
+    double buildSeconds = secondsSince(start);
+
+    // Queries: real names with one typo, and short prefixes
+    std::vector<std::string> typos, prefixes;
+    for (size_t q = 0; q < 200; ++q) {
+        std::string name = roster[random() % roster.size()].second;
+        name[1 + random() % (name.size() - 1)] = 'x';
+        typos.push_back(name);
+        prefixes.push_back(roster[random() % roster.size()].second.substr(0, 6));
+    }
+
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& query : prefixes) found += index.findPrefix(query).size();
+    double prefixSeconds = secondsSince(start) / prefixes.size();
+    start = std::chrono::steady_clock::now();
+    for (const auto& query : typos) found += index.findSimilar(query).size();
+    double fuzzySeconds = secondsSince(start) / typos.size();
+
+    // The linear scan a lookup needs without the index
+    const size_t scans = 10;
+    start = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < scans; ++q) {
+        std::string key = NameIndex::normalize(prefixes[q]);
+        for (const auto& [id, name] : roster) {
+            found += NameIndex::normalize(name).compare(0, key.size(), key) == 0;
+        }
+    }
+    double prefixScanSeconds = secondsSince(start) / scans;
+    start = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < scans; ++q) {
+        std::string key = NameIndex::normalize(typos[q]);
+        for (const auto& [id, name] : roster) {
+            found += NameIndex::withinOneEdit(NameIndex::normalize(name), key);
+        }
+    }
+    double fuzzyScanSeconds = secondsSince(start) / scans;
+
+    std::cout<<"Distinct names:          "<<index.getDistinctNameCount()<<std::endl;
+    std::cout<<"Index build:             "<<buildSeconds<<" s"<<std::endl;
+    std::cout<<"Prefix lookup:           "<<prefixSeconds * 1e6<<" us (scan "<<prefixScanSeconds * 1e6<<" us)"<<std::endl;
+    std::cout<<"Edit-distance-1 lookup:  "<<fuzzySeconds * 1e6<<" us (scan "<<fuzzyScanSeconds * 1e6<<" us)"<<std::endl;
+    std::cout<<"(matches counted: "<<found<<")"<<std::endl;
+    std::cout<<"\n";
+}
+
+// Loads a feed written by writeFeed; returns the load time
+static double loadFeed(std::map<std::string, Student>& students) {
+    QuietOutput quiet;
+    auto start = std::chrono::steady_clock::now();
+    FileReader nameFile ("bench_names.txt");
+    nameFile.readNameFile(students);
+    FileReader courseFile ("bench_courses.txt");
+    courseFile.readCourseFile(students);
+    return secondsSince(start);
+}
+
+void benchRanking(size_t studentCount){
+    std::cout<<"--------BENCHMARK: RANKING ("<<studentCount<<" students)--------"<<std::endl;
+    writeFeed("bench_names.txt", "bench_courses.txt", studentCount);
+
+    std::map<std::string, Student> students;
+    double loadSeconds = loadFeed(students);
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    auto start = std::chrono::steady_clock::now();
+    Ranking serial(students, 1);
+    double serialSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    Ranking parallel(students, threads);
+    double parallelSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    std::vector<RankedStudent> best = Ranking::top(students, 10);
+    double topSeconds = secondsSince(start);
+
+    std::cout<<"Load time:               "<<loadSeconds<<" s"<<std::endl;
+    std::cout<<"Ranking, 1 thread:       "<<serialSeconds<<" s ("<<serialSeconds / loadSeconds<<"x load)"<<std::endl;
+    std::cout<<"Ranking, all threads:    "<<parallelSeconds<<" s ("<<parallelSeconds / loadSeconds<<"x load, "
+             <<threads<<" threads)"<<std::endl;
+    std::cout<<"Top 10:                  "<<topSeconds<<" s"<<std::endl;
+    std::cout<<"(ranked: "<<serial.getStudentCount() + parallel.getStudentCount() + best.size()<<")"<<std::endl;
+    std::cout<<"\n";
+
+    std::remove("bench_names.txt");
+    std::remove("bench_courses.txt");
+}
+
+void benchCompressedOutput(size_t studentCount){
+    std::cout<<"--------BENCHMARK: COMPRESSED OUTPUT ("<<studentCount<<" students)--------"<<std::endl;
+    writeFeed("bench_names.txt", "bench_courses.txt", studentCount);
+    std::map<std::string, Student> students;
+    loadFeed(students);
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Throughput is uncompressed Output.txt bytes per second, so every row is comparable
+    std::ofstream("bench_output.txt").close();
+    double seconds;
+    {
+        QuietOutput quiet;
+        auto start = std::chrono::steady_clock::now();
+        FileWriter plain ("bench_output.txt");
+        plain.writeOutputFile(students);
+        seconds = secondsSince(start);
+    }
+    std::ifstream plainFile("bench_output.txt", std::ios::binary | std::ios::ate);
+    double megabytes = static_cast<double>(plainFile.tellg()) / (1024.0 * 1024.0);
+    std::cout<<"Plain text:              "<<megabytes / seconds<<" MB/s ("<<megabytes<<" MB)"<<std::endl;
+
+    std::vector<unsigned> threadCounts(1, 1);
+    if (threads > 1) {
+        threadCounts.push_back(threads);
+    }
+    const int levels[] = {1, GZIP_DEFAULT_LEVEL, GZIP_MAX_LEVEL};
+    for (int level : levels) {
+        for (unsigned count : threadCounts) {
+            std::ofstream("bench_output.gz").close();
+            {
+                QuietOutput quiet;
+                auto start = std::chrono::steady_clock::now();
+                FileWriter compressed ("bench_output.gz");
+                compressed.writeCompressedOutputFile(students, level, count);
+                seconds = secondsSince(start);
+            }
+            std::ifstream compressedFile("bench_output.gz", std::ios::binary | std::ios::ate);
+            double ratio = static_cast<double>(compressedFile.tellg()) / (1024.0 * 1024.0) / megabytes;
+            std::cout<<"Gzip level "<<level<<", "<<count<<" thread"<<(count > 1 ? "s: " : ":  ")
+                     <<megabytes / seconds<<" MB/s ("<<100.0 * ratio<<"% of plain)"<<std::endl;
+        }
+    }
+    std::cout<<"\n";
+
+    std::remove("bench_names.txt");
+    std::remove("bench_courses.txt");
+    std::remove("bench_output.txt");
+    std::remove("bench_output.gz");
+}
+
+
+int main(int argc, char* argv[]) {
+    size_t students = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t searchStudents = argc > 2 ? std::stoul(argv[2]) : 3000000;
+
+    benchIngest(students);
+    benchNameSearch(searchStudents);
+    benchRanking(students);
+    benchCompressedOutput(students);
+
+    return 0;
+}
+
+
+std::vector<std::string> split(const std::string& str, char delimiter) {
+    std::vector<std::string> tokens;
+    std::stringstream ss(str);
+    std::string token;
+
+    while (std::getline(ss, token, delimiter)) {
+        tokens.push_back(token);
+    }
+
+    return tokens;
+}
+
+std::string trim(const std::string& str) {
+    size_t start = str.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) return "";
+
+    size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(start, end - start + 1);
+}
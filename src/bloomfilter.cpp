@@ -0,0 +1,75 @@
+#include "bloomfilter.h"
+#include <cmath>
+#include <stdexcept>
+
+BloomFilter::BloomFilter(size_t expectedItems, double falsePositiveRate) : itemCount(0) {
+    if (falsePositiveRate <= 0.0 || falsePositiveRate >= 1.0) {
+        throw std::invalid_argument("Bloom filter false-positive rate must be between 0 and 1");
+    }
+    if (expectedItems < 1) {
+        expectedItems = 1;
+    }
+
+    // Optimal sizing: m = -n ln(p) / ln(2)^2 bits, k = (m / n) ln(2) hashes
+    double ln2 = std::log(2.0);
+    bitCount = static_cast<uint64_t>(std::ceil(-static_cast<double>(expectedItems) * std::log(falsePositiveRate) / (ln2 * ln2)));
+    bitCount = ((bitCount + 63) / 64) * 64;
+    hashCount = static_cast<unsigned>(std::round(static_cast<double>(bitCount) / expectedItems * ln2));
+    if (hashCount < 1) {
+        hashCount = 1;
+    }
+    bits.assign(bitCount / 64, 0);
+}
+
+// FNV-1a with a seed; two of these drive the double hashing below
+uint64_t BloomFilter::hash(const std::string& key, uint64_t seed) {
+    uint64_t h = 14695981039346656037ULL ^ seed;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+void BloomFilter::add(const std::string& key) {
+    uint64_t h1 = hash(key, 0);
+    uint64_t h2 = hash(key, 0x9e3779b97f4a7c15ULL) | 1;
+    for (unsigned i = 0; i < hashCount; ++i) {
+        uint64_t bit = (h1 + i * h2) % bitCount;
+        bits[bit / 64] |= 1ULL << (bit % 64);
+    }
+    itemCount++;
+}
+
+bool BloomFilter::mightContain(const std::string& key) const {
+    uint64_t h1 = hash(key, 0);
+    uint64_t h2 = hash(key, 0x9e3779b97f4a7c15ULL) | 1;
+    for (unsigned i = 0; i < hashCount; ++i) {
+        uint64_t bit = (h1 + i * h2) % bitCount;
+        if (!(bits[bit / 64] & (1ULL << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t BloomFilter::getBitCount() const {
+    return bitCount;
+}
+
+unsigned BloomFilter::getHashCount() const {
+    return hashCount;
+}
+
+size_t BloomFilter::getItemCount() const {
+    return itemCount;
+}
+
+// (1 - e^(-kn/m))^k for the items actually added
+double BloomFilter::getExpectedFalsePositiveRate() const {
+    double fill = 1.0 - std::exp(-static_cast<double>(hashCount) * itemCount / bitCount);
+    return std::pow(fill, hashCount);
+}
@@ -0,0 +1,32 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Membership sketch over student IDs. mightContain() never returns false for
+// an added ID, and returns true for an absent one with roughly the
+// configured false-positive rate.
+class BloomFilter {
+    private:
+        std::vector<uint64_t> bits;
+        uint64_t bitCount;
+        unsigned hashCount;
+        size_t itemCount;
+
+        static uint64_t hash(const std::string& key, uint64_t seed);
+
+    public:
+        BloomFilter(size_t expectedItems, double falsePositiveRate);
+
+        void add(const std::string& key);
+        bool mightContain(const std::string& key) const;
+
+        uint64_t getBitCount() const;
+        unsigned getHashCount() const;
+        size_t getItemCount() const;
+        double getExpectedFalsePositiveRate() const;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "bulkvalidation.h"
+#include "exceptions.h"
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+BulkValidator::BulkValidator() : rejectedCount(0) {}
+
+void BulkValidator::resize(size_t rows) {
+    test1.assign(rows, 0.0f);
+    test2.assign(rows, 0.0f);
+    test3.assign(rows, 0.0f);
+    finalExam.assign(rows, 0.0f);
+    codes.assign(rows, 0);
+    codeLengths.assign(rows, 0);
+    rejectBitmap.assign((rows + 63) / 64, 0);
+    reasons.assign(rows, REJECT_NONE);
+    rejectedCount = 0;
+}
+
+void BulkValidator::setRow(size_t row, const std::string& code, float t1, float t2, float t3, float exam) {
+    test1[row] = t1;
+    test2[row] = t2;
+    test3[row] = t3;
+    finalExam[row] = exam;
+    codeLengths[row] = static_cast<uint8_t>(code.size() > 255 ? 255 : code.size());
+    uint64_t packed = 0;
+    std::memcpy(&packed, code.data(), code.size() < 8 ? code.size() : 8);
+    codes[row] = packed;
+}
+
+static bool validCode(uint64_t packed) {
+    unsigned char c[8];
+    std::memcpy(c, &packed, 8);
+    auto letter = [](unsigned char ch) { return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z'); };
+    auto digit = [](unsigned char ch) { return ch >= '0' && ch <= '9'; };
+    return letter(c[0]) && letter(c[1]) && digit(c[2]) && digit(c[3]) && digit(c[4]);
+}
+
+// Same rule as CourseCodeExceptionCheck: five characters, two letters then three digits
+void BulkValidator::checkCodes(size_t begin, size_t end) {
+    size_t row = begin;
+#ifdef __SSE2__
+    // Two codes per register; letter positions 0-1, digit positions 2-4, padding 5-7
+    const __m128i letterMask = _mm_set_epi8(0, 0, 0, 0, 0, 0, -1, -1, 0, 0, 0, 0, 0, 0, -1, -1);
+    const __m128i digitMask = _mm_set_epi8(0, 0, 0, -1, -1, -1, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0);
+    const __m128i padMask = _mm_set_epi8(-1, -1, -1, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0, 0, 0, 0);
+    for (; row + 2 <= end; row += 2) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&codes[row]));
+        __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+        __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                         _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+        __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        __m128i ok = _mm_or_si128(_mm_or_si128(_mm_and_si128(isLetter, letterMask),
+                                               _mm_and_si128(isDigit, digitMask)), padMask);
+        int mask = _mm_movemask_epi8(ok);
+        if ((mask & 0xFF) != 0xFF && reasons[row] == REJECT_NONE) reasons[row] = REJECT_COURSE_CODE;
+        if ((mask >> 8) != 0xFF && reasons[row + 1] == REJECT_NONE) reasons[row + 1] = REJECT_COURSE_CODE;
+    }
+#endif
+    for (; row < end; ++row) {
+        if (!validCode(codes[row]) && reasons[row] == REJECT_NONE) {
+            reasons[row] = REJECT_COURSE_CODE;
+        }
+    }
+}
+
+// Same rule as GradeExceptionCheck: reject score > 100 || score < 0
+void BulkValidator::checkGrades(const std::vector<float>& column, RejectReason reason) {
+    size_t rows = column.size();
+    size_t row = 0;
+#ifdef __SSE2__
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 hundred = _mm_set1_ps(100.0f);
+    for (; row + 4 <= rows; row += 4) {
+        __m128 x = _mm_loadu_ps(&column[row]);
+        int mask = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpgt_ps(x, hundred)));
+        while (mask) {
+            int lane = __builtin_ctz(mask);
+            if (reasons[row + lane] == REJECT_NONE) reasons[row + lane] = reason;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; row < rows; ++row) {
+        if ((column[row] > 100 || column[row] < 0) && reasons[row] == REJECT_NONE) {
+            reasons[row] = reason;
+        }
+    }
+}
+
+void BulkValidator::validate() {
+    size_t rows = reasons.size();
+    std::fill(reasons.begin(), reasons.end(), REJECT_NONE);
+
+    for (size_t row = 0; row < rows; ++row) {
+        if (codeLengths[row] != 5) reasons[row] = REJECT_COURSE_CODE;
+    }
+    checkCodes(0, rows);
+    checkGrades(test1, REJECT_TEST1);
+    checkGrades(test2, REJECT_TEST2);
+    checkGrades(test3, REJECT_TEST3);
+    checkGrades(finalExam, REJECT_FINAL_EXAM);
+
+    std::fill(rejectBitmap.begin(), rejectBitmap.end(), 0);
+    rejectedCount = 0;
+    for (size_t row = 0; row < rows; ++row) {
+        if (reasons[row] != REJECT_NONE) {
+            rejectBitmap[row / 64] |= 1ULL << (row % 64);
+            rejectedCount++;
+        }
+    }
+}
+
+size_t BulkValidator::getRowCount() const {
+    return reasons.size();
+}
+
+size_t BulkValidator::getRejectedCount() const {
+    return rejectedCount;
+}
+
+bool BulkValidator::isRejected(size_t row) const {
+    return (rejectBitmap[row / 64] >> (row % 64)) & 1;
+}
+
+RejectReason BulkValidator::getReason(size_t row) const {
+    return static_cast<RejectReason>(reasons[row]);
+}
+
+void BulkValidator::throwReason(RejectReason reason, const std::string& code, float t1, float t2, float t3, float exam) {
+    switch (reason) {
+        case REJECT_COURSE_CODE:
+            throw CourseExceptionError(code);
+        case REJECT_TEST1:
+            throw ValidGrade("Out of Range: " + std::to_string(t1));
+        case REJECT_TEST2:
+            throw ValidGrade("Out of Range: " + std::to_string(t2));
+        case REJECT_TEST3:
+            throw ValidGrade("Out of Range: " + std::to_string(t3));
+        case REJECT_FINAL_EXAM:
+            throw ValidGrade("Out of Range: " + std::to_string(exam));
+        default:
+            return;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef BULKVALIDATION_H
+#define BULKVALIDATION_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Why a row failed bulk validation. Values follow the order the Course
+// constructor checks in, so the first failing check is the one reported.
+enum RejectReason : uint8_t {
+    REJECT_NONE = 0,
+    REJECT_COURSE_CODE,
+    REJECT_TEST1,
+    REJECT_TEST2,
+    REJECT_TEST3,
+    REJECT_FINAL_EXAM
+};
+
+// Column-at-a-time validation of course rows. Grades are range-checked and
+// course codes pattern-checked with SSE2 where available (scalar otherwise),
+// producing a reject bitmap and a reason code per row.
+class BulkValidator {
+    private:
+        std::vector<float> test1, test2, test3, finalExam;
+        std::vector<uint64_t> codes;          // course code bytes, zero padded to 8
+        std::vector<uint8_t> codeLengths;
+        std::vector<uint64_t> rejectBitmap;
+        std::vector<uint8_t> reasons;
+        size_t rejectedCount;
+
+        void checkCodes(size_t begin, size_t end);
+        void checkGrades(const std::vector<float>& column, RejectReason reason);
+
+    public:
+        BulkValidator();
+
+        void resize(size_t rows);
+        void setRow(size_t row, const std::string& code, float t1, float t2, float t3, float exam);
+        void validate();
+
+        size_t getRowCount() const;
+        size_t getRejectedCount() const;
+        bool isRejected(size_t row) const;
+        RejectReason getReason(size_t row) const;
+
+        // Throws exactly what Course(code, t1, t2, t3, exam) would have thrown
+        static void throwReason(RejectReason reason, const std::string& code, float t1, float t2, float t3, float exam);
+};
+
+#endif
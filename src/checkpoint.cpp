@@ -0,0 +1,201 @@
+#include "checkpoint.h"
+#include "exceptions.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+
+Checkpoint::Checkpoint(const std::string& checkpointPath, const std::string& nameFilePath,
+                       const std::string& courseFilePath, size_t rowInterval)
+    : path(checkpointPath), nameFile(nameFilePath), courseFile(courseFilePath), interval(rowInterval),
+      rowsSinceSave(0), stage(CHECKPOINT_NONE), offset(0), lineNumber(0), courseStats() {}
+
+void Checkpoint::readSourceStats(CheckpointHeader& header) const {
+    header.nameFileSize = std::filesystem::file_size(nameFile);
+    header.nameFileTime = std::filesystem::last_write_time(nameFile).time_since_epoch().count();
+    header.courseFileSize = std::filesystem::file_size(courseFile);
+    header.courseFileTime = std::filesystem::last_write_time(courseFile).time_since_epoch().count();
+}
+
+bool Checkpoint::load(std::map<std::string, Student>& students) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0
+        || header.version != CHECKPOINT_VERSION
+        || (header.stage != CHECKPOINT_NAMES && header.stage != CHECKPOINT_COURSES)) {
+        std::cerr << "Warning: " << path << " is not a checkpoint, starting over" << std::endl;
+        return false;
+    }
+    CheckpointHeader current;
+    readSourceStats(current);
+    if (header.nameFileSize != current.nameFileSize || header.nameFileTime != current.nameFileTime
+        || header.courseFileSize != current.courseFileSize || header.courseFileTime != current.courseFileTime) {
+        std::cerr << "Warning: The input files changed since checkpoint " << path << ", starting over" << std::endl;
+        return false;
+    }
+
+    // The sections must add up to the file size before any is allocated; each
+    // count is checked against what is left, so the sum cannot overflow
+    std::error_code error;
+    uint64_t remaining = std::filesystem::file_size(path, error);
+    bool sized = !error && remaining >= sizeof(header);
+    remaining -= sized ? sizeof(header) : 0;
+    sized = sized && header.studentCount <= remaining / sizeof(CheckpointStudent);
+    remaining -= sized ? header.studentCount * sizeof(CheckpointStudent) : 0;
+    sized = sized && header.courseCount <= remaining / sizeof(CheckpointCourse);
+    remaining -= sized ? header.courseCount * sizeof(CheckpointCourse) : 0;
+    if (!sized || header.stringBytes != remaining) {
+        std::cerr << "Warning: Checkpoint " << path << " is malformed, starting over" << std::endl;
+        return false;
+    }
+
+    std::vector<CheckpointStudent> rows(header.studentCount);
+    std::vector<CheckpointCourse> courses(header.courseCount);
+    std::string strings(header.stringBytes, '\0');
+    in.read(reinterpret_cast<char*>(rows.data()), rows.size() * sizeof(CheckpointStudent));
+    in.read(reinterpret_cast<char*>(courses.data()), courses.size() * sizeof(CheckpointCourse));
+    in.read(&strings[0], strings.size());
+    if (!in) {
+        std::cerr << "Warning: Checkpoint " << path << " is truncated, starting over" << std::endl;
+        return false;
+    }
+
+    // Lengths are checked against what was read before any string is cut
+    students.clear();
+    size_t nextCourse = 0;
+    size_t nextString = 0;
+    for (const auto& row : rows) {
+        size_t studentBytes = static_cast<size_t>(row.idLength) + row.nameLength;
+        if (row.courseCount > Student::MAX_COURSES || nextCourse + row.courseCount > courses.size()
+            || studentBytes > strings.size() - nextString) {
+            students.clear();
+            std::cerr << "Warning: Checkpoint " << path << " is malformed, starting over" << std::endl;
+            return false;
+        }
+        Student student;
+        student.setStudentID(strings.substr(nextString, row.idLength));
+        student.setStudentName(strings.substr(nextString + row.idLength, row.nameLength));
+        nextString += studentBytes;
+        for (uint32_t i = 0; i < row.courseCount; ++i) {
+            const CheckpointCourse& course = courses[nextCourse++];
+            if (course.codeLength > strings.size() - nextString) {
+                students.clear();
+                std::cerr << "Warning: Checkpoint " << path << " is malformed, starting over" << std::endl;
+                return false;
+            }
+            // A duplicate is stored before it is reported, as when it was first read
+            try {
+                student.addValidatedCourse(Course::createValidated(strings.substr(nextString, course.codeLength),
+                                                                   course.test1, course.test2, course.test3,
+                                                                   course.finalExam));
+            } catch (const CourseAlreadyExists&) {
+            }
+            nextString += course.codeLength;
+        }
+        std::string id = student.getStudentID();
+        students.emplace_hint(students.end(), std::move(id), std::move(student));
+    }
+
+    stage = static_cast<CheckpointStage>(header.stage);
+    offset = header.offset;
+    lineNumber = static_cast<int>(header.lineNumber);
+    courseStats.coursesAdded = header.coursesAdded;
+    courseStats.filterRejected = header.filterRejected;
+    courseStats.filterPassed = header.filterPassed;
+    courseStats.filterFalsePositives = header.filterFalsePositives;
+    rowsSinceSave = 0;
+    return true;
+}
+
+bool Checkpoint::rowApplied() {
+    return interval > 0 && ++rowsSinceSave >= interval;
+}
+
+void Checkpoint::save(CheckpointStage readerStage, uint64_t readerOffset, int readerLine, const CourseLoadStats& stats,
+                      const std::map<std::string, Student>& students) {
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.stage = readerStage;
+    readSourceStats(header);
+    header.offset = readerOffset;
+    header.lineNumber = static_cast<uint32_t>(readerLine);
+    header.coursesAdded = stats.coursesAdded;
+    header.filterRejected = stats.filterRejected;
+    header.filterPassed = stats.filterPassed;
+    header.filterFalsePositives = stats.filterFalsePositives;
+
+    std::vector<CheckpointStudent> rows;
+    std::vector<CheckpointCourse> courses;
+    std::string strings;
+    rows.reserve(students.size());
+    for (const auto& [id, student] : students) {
+        rows.push_back({static_cast<uint32_t>(student.getStudentID().size()),
+                        static_cast<uint32_t>(student.getStudentName().size()),
+                        static_cast<uint32_t>(student.getCourseCount()), 0});
+        strings += student.getStudentID();
+        strings += student.getStudentName();
+        for (const auto& course : student.getCourses()) {
+            courses.push_back({static_cast<uint32_t>(course.getCourseCode().size()), course.getTest1(),
+                               course.getTest2(), course.getTest3(), course.getFinalExam()});
+            strings += course.getCourseCode();
+        }
+    }
+    header.studentCount = rows.size();
+    header.courseCount = courses.size();
+    header.stringBytes = strings.size();
+
+    // Renamed into place, so a run killed mid-write leaves the previous snapshot
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(temporary);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(CheckpointStudent));
+    out.write(reinterpret_cast<const char*>(courses.data()), courses.size() * sizeof(CheckpointCourse));
+    out.write(strings.data(), strings.size());
+    out.close();
+    if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw FileAccessException(path);
+    }
+
+    stage = readerStage;
+    offset = readerOffset;
+    lineNumber = readerLine;
+    courseStats = stats;
+    rowsSinceSave = 0;
+}
+
+void Checkpoint::discard() {
+    std::remove(path.c_str());
+}
+
+CheckpointStage Checkpoint::getStage() const {
+    return stage;
+}
+
+uint64_t Checkpoint::getOffset() const {
+    return offset;
+}
+
+int Checkpoint::getLineNumber() const {
+    return lineNumber;
+}
+
+const CourseLoadStats& Checkpoint::getCourseStats() const {
+    return courseStats;
+}
+
+const std::string& Checkpoint::getPath() const {
+    return path;
+}
@@ -0,0 +1,105 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include "student.h"
+#include "filereader.h"
+
+// Periodic snapshot of a load in progress, so a run that dies part way
+// through NameFile.txt or CourseFile.txt resumes where the last snapshot
+// left off instead of starting over. A snapshot holds the input file being
+// read, the byte offset and line number reached in it, the course counters
+// and every student built so far; it is written beside the target and
+// renamed into place, so the file on disk is always a complete snapshot.
+// The inputs' sizes and times are recorded, and a snapshot of other inputs
+// is ignored.
+//
+//  [CheckpointHeader][CheckpointStudent x studentCount][CheckpointCourse x courseCount][string bytes]
+//
+// The string bytes hold each student's ID and name, then its course codes.
+
+const char CHECKPOINT_MAGIC[8] = {'C', 'P', '3', '1', '7', 'C', 'K', 'P'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+enum CheckpointStage : uint32_t {
+    CHECKPOINT_NONE = 0,
+    CHECKPOINT_NAMES = 1,       // reading NameFile.txt
+    CHECKPOINT_COURSES = 2      // NameFile.txt done, reading CourseFile.txt
+};
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t stage;
+    uint64_t nameFileSize;
+    int64_t nameFileTime;
+    uint64_t courseFileSize;
+    int64_t courseFileTime;
+    uint64_t offset;            // where the stage's file resumes
+    uint32_t lineNumber;        // lines read before offset
+    int32_t coursesAdded;
+    int32_t filterRejected;
+    int32_t filterPassed;
+    int32_t filterFalsePositives;
+    uint32_t reserved;
+    uint64_t studentCount;
+    uint64_t courseCount;
+    uint64_t stringBytes;
+};
+
+// Students in ID order; their courses are contiguous
+struct CheckpointStudent {
+    uint32_t idLength;
+    uint32_t nameLength;
+    uint32_t courseCount;
+    uint32_t reserved;
+};
+
+struct CheckpointCourse {
+    uint32_t codeLength;
+    float test1, test2, test3, finalExam;
+};
+
+class Checkpoint {
+    private:
+        std::string path;
+        std::string nameFile;
+        std::string courseFile;
+        size_t interval;            // rows between snapshots
+        size_t rowsSinceSave;
+
+        CheckpointStage stage;
+        uint64_t offset;
+        int lineNumber;
+        CourseLoadStats courseStats;
+
+        void readSourceStats(CheckpointHeader& header) const;
+
+    public:
+        Checkpoint(const std::string& checkpointPath, const std::string& nameFilePath,
+                   const std::string& courseFilePath, size_t rowInterval);
+
+        // Restores the students of a snapshot of the same inputs; false, with
+        // a warning if a snapshot was found but not used, when starting over
+        bool load(std::map<std::string, Student>& students);
+
+        // Counts one row; true when a snapshot is due
+        bool rowApplied();
+
+        // Replaces the snapshot; throws FileAccessException
+        void save(CheckpointStage readerStage, uint64_t readerOffset, int readerLine, const CourseLoadStats& stats,
+                  const std::map<std::string, Student>& students);
+
+        // Removes the snapshot once the run has finished
+        void discard();
+
+        CheckpointStage getStage() const;
+        uint64_t getOffset() const;
+        int getLineNumber() const;
+        const CourseLoadStats& getCourseStats() const;
+        const std::string& getPath() const;
+};
+
+#endif
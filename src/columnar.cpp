@@ -0,0 +1,235 @@
+#include "columnar.h"
+#include <fstream>
+#include <cstring>
+#include "exceptions.h"
+
+static const char* COLUMN_NAMES[] = {"student_id", "student_name", "course_code", "final_grade"};
+static const uint32_t COLUMN_COUNT = 4;
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + COLUMNAR_ALIGNMENT - 1) & ~(COLUMNAR_ALIGNMENT - 1);
+}
+
+void StringColumn::append(const std::string& value) {
+    data += value;
+    offsets.push_back(static_cast<int32_t>(data.size()));
+}
+
+std::string StringColumn::at(size_t row) const {
+    return data.substr(offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+size_t ColumnarTable::rowCount() const {
+    return finalGrade.size();
+}
+
+ColumnarTable buildColumnarTable(const std::map<std::string, Student>& students, const GradeEngine* engine) {
+    ColumnarTable table;
+    for (const auto& [id, student] : students) {
+        for (const auto& course : student.getCourses()) {
+            table.studentID.append(student.getStudentID());
+            table.studentName.append(student.getStudentName());
+            table.courseCode.append(course.getCourseCode());
+            bool useEngine = engine && !engine->usesBuiltInFormula();
+            table.finalGrade.push_back(useEngine ? engine->calculateFinalGrade(course) : course.calculateFinalGrade());
+        }
+    }
+    return table;
+}
+
+// Buffers are staged into one block and flushed once it fills, so the
+// file is written in COLUMNAR_BLOCK_SIZE chunks rather than per value
+class BlockWriter {
+    private:
+        std::ofstream& out;
+        std::string block;
+        uint64_t written;
+
+    public:
+        BlockWriter(std::ofstream& file) : out(file), written(0) {
+            block.reserve(COLUMNAR_BLOCK_SIZE);
+        }
+
+        void write(const void* data, size_t length) {
+            const char* bytes = static_cast<const char*>(data);
+            while (length > 0) {
+                size_t room = COLUMNAR_BLOCK_SIZE - block.size();
+                size_t chunk = length < room ? length : room;
+                block.append(bytes, chunk);
+                bytes += chunk;
+                length -= chunk;
+                written += chunk;
+                if (block.size() == COLUMNAR_BLOCK_SIZE) {
+                    flush();
+                }
+            }
+        }
+
+        void pad() {
+            static const char zeros[COLUMNAR_ALIGNMENT] = {};
+            write(zeros, alignUp(written) - written);
+        }
+
+        void flush() {
+            out.write(block.data(), block.size());
+            block.clear();
+        }
+
+        uint64_t position() const {
+            return written;
+        }
+};
+
+static ColumnarDescriptor makeDescriptor(uint32_t index, uint32_t type) {
+    ColumnarDescriptor descriptor;
+    std::memset(&descriptor, 0, sizeof(descriptor));
+    std::strncpy(descriptor.name, COLUMN_NAMES[index], sizeof(descriptor.name) - 1);
+    descriptor.type = type;
+    return descriptor;
+}
+
+void writeColumnarFile(const std::string& filename, const ColumnarTable& table) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(filename);
+    }
+
+    const StringColumn* strings[] = {&table.studentID, &table.studentName, &table.courseCode};
+    ColumnarDescriptor descriptors[COLUMN_COUNT];
+
+    // Lay out every buffer on an aligned offset before writing anything
+    uint64_t position = alignUp(sizeof(ColumnarHeader) + sizeof(descriptors));
+    for (uint32_t i = 0; i < 3; ++i) {
+        descriptors[i] = makeDescriptor(i, COLUMNAR_UTF8);
+        descriptors[i].offsetsStart = position;
+        descriptors[i].offsetsLength = strings[i]->offsets.size() * sizeof(int32_t);
+        position = alignUp(position + descriptors[i].offsetsLength);
+        descriptors[i].dataStart = position;
+        descriptors[i].dataLength = strings[i]->data.size();
+        position = alignUp(position + descriptors[i].dataLength);
+    }
+    descriptors[3] = makeDescriptor(3, COLUMNAR_FLOAT32);
+    descriptors[3].dataStart = position;
+    descriptors[3].dataLength = table.finalGrade.size() * sizeof(float);
+
+    ColumnarHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, COLUMNAR_MAGIC, sizeof(header.magic));
+    header.version = COLUMNAR_VERSION;
+    header.columnCount = COLUMN_COUNT;
+    header.rowCount = table.rowCount();
+
+    BlockWriter writer(out);
+    writer.write(&header, sizeof(header));
+    writer.write(descriptors, sizeof(descriptors));
+    writer.pad();
+    for (uint32_t i = 0; i < 3; ++i) {
+        writer.write(strings[i]->offsets.data(), descriptors[i].offsetsLength);
+        writer.pad();
+        writer.write(strings[i]->data.data(), descriptors[i].dataLength);
+        writer.pad();
+    }
+    writer.write(table.finalGrade.data(), descriptors[3].dataLength);
+    writer.pad();
+    writer.write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    writer.flush();
+
+    if (!out) {
+        throw FileAccessException(filename);
+    }
+}
+
+// Written so that a huge start or length cannot wrap around the sum
+static void checkBuffer(uint64_t start, uint64_t length, uint64_t fileSize) {
+    if (start % COLUMNAR_ALIGNMENT != 0)
+        throw ColumnarFormatException("unaligned buffer at " + std::to_string(start));
+    if (length > fileSize || start > fileSize - length)
+        throw ColumnarFormatException("buffer runs past end of file");
+}
+
+// The buffer is checked by the caller before its target is sized
+static void readBuffer(std::ifstream& in, uint64_t start, uint64_t length, void* target) {
+    in.seekg(start);
+    in.read(static_cast<char*>(target), length);
+    if (!in)
+        throw ColumnarFormatException("short read at " + std::to_string(start));
+}
+
+static void readStringColumn(std::ifstream& in, const ColumnarDescriptor& descriptor, uint64_t rows,
+                             uint64_t fileSize, StringColumn& column) {
+    if (descriptor.type != COLUMNAR_UTF8)
+        throw ColumnarFormatException(std::string("column ") + descriptor.name + " is not UTF8");
+    if (descriptor.offsetsLength != (rows + 1) * sizeof(int32_t))
+        throw ColumnarFormatException(std::string("bad offsets length in ") + descriptor.name);
+
+    checkBuffer(descriptor.offsetsStart, descriptor.offsetsLength, fileSize);
+    checkBuffer(descriptor.dataStart, descriptor.dataLength, fileSize);
+
+    column.offsets.resize(rows + 1);
+    column.data.resize(descriptor.dataLength);
+    readBuffer(in, descriptor.offsetsStart, descriptor.offsetsLength, column.offsets.data());
+    readBuffer(in, descriptor.dataStart, descriptor.dataLength, &column.data[0]);
+
+    if (column.offsets[0] != 0 || static_cast<uint64_t>(column.offsets[rows]) != descriptor.dataLength)
+        throw ColumnarFormatException(std::string("offsets do not span data in ") + descriptor.name);
+    for (uint64_t i = 0; i < rows; ++i) {
+        if (column.offsets[i] > column.offsets[i + 1])
+            throw ColumnarFormatException(std::string("decreasing offsets in ") + descriptor.name);
+    }
+}
+
+ColumnarTable readColumnarFile(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        throw FileAccessException(filename);
+    }
+    uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    ColumnarHeader header;
+    ColumnarDescriptor descriptors[COLUMN_COUNT];
+    if (fileSize < sizeof(header) + sizeof(descriptors) + sizeof(COLUMNAR_MAGIC))
+        throw ColumnarFormatException("file too small");
+
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (std::memcmp(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) != 0)
+        throw ColumnarFormatException("bad magic");
+    if (header.version != COLUMNAR_VERSION)
+        throw ColumnarFormatException("unsupported version " + std::to_string(header.version));
+    if (header.columnCount != COLUMN_COUNT)
+        throw ColumnarFormatException("expected 4 columns, got " + std::to_string(header.columnCount));
+    // Every row takes at least a float and three offsets, so this bounds each size below
+    if (header.rowCount > fileSize / (sizeof(float) + 3 * sizeof(int32_t)))
+        throw ColumnarFormatException("row count " + std::to_string(header.rowCount) + " does not fit the file");
+
+    in.read(reinterpret_cast<char*>(descriptors), sizeof(descriptors));
+    for (uint32_t i = 0; i < COLUMN_COUNT; ++i) {
+        if (std::strncmp(descriptors[i].name, COLUMN_NAMES[i], sizeof(descriptors[i].name)) != 0)
+            throw ColumnarFormatException("unexpected column " + std::string(descriptors[i].name, 16));
+    }
+
+    char footer[sizeof(COLUMNAR_MAGIC)];
+    in.seekg(fileSize - sizeof(footer));
+    in.read(footer, sizeof(footer));
+    if (std::memcmp(footer, COLUMNAR_MAGIC, sizeof(footer)) != 0)
+        throw ColumnarFormatException("missing footer (truncated file?)");
+
+    ColumnarTable table;
+    readStringColumn(in, descriptors[0], header.rowCount, fileSize, table.studentID);
+    readStringColumn(in, descriptors[1], header.rowCount, fileSize, table.studentName);
+    readStringColumn(in, descriptors[2], header.rowCount, fileSize, table.courseCode);
+
+    if (descriptors[3].type != COLUMNAR_FLOAT32 || descriptors[3].dataLength != header.rowCount * sizeof(float))
+        throw ColumnarFormatException("bad final_grade column");
+    checkBuffer(descriptors[3].dataStart, descriptors[3].dataLength, fileSize);
+    table.finalGrade.resize(header.rowCount);
+    readBuffer(in, descriptors[3].dataStart, descriptors[3].dataLength, table.finalGrade.data());
+
+    // Output.txt ordering: rows must be sorted by student ID
+    for (uint64_t i = 1; i < header.rowCount; ++i) {
+        if (table.studentID.at(i) < table.studentID.at(i - 1))
+            throw ColumnarFormatException("rows not sorted by student ID at row " + std::to_string(i));
+    }
+
+    return table;
+}
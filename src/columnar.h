@@ -0,0 +1,75 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include "student.h"
+#include "gradeengine.h"
+
+// Columnar binary output for downstream analytics.
+// Layout follows the Arrow columnar conventions: every buffer starts on a
+// 64-byte boundary, string columns are int32 offsets + UTF-8 bytes and the
+// grade column is a plain float32 array. All integers are little-endian.
+//
+//  [ColumnarHeader][ColumnarDescriptor x columnCount][buffers...][footer magic]
+
+const char COLUMNAR_MAGIC[8] = {'C', 'P', '3', '1', '7', 'C', 'O', 'L'};
+const uint32_t COLUMNAR_VERSION = 1;
+const uint64_t COLUMNAR_ALIGNMENT = 64;
+const size_t COLUMNAR_BLOCK_SIZE = 1 << 16;
+
+enum ColumnarType : uint32_t {
+    COLUMNAR_UTF8 = 1,
+    COLUMNAR_FLOAT32 = 2
+};
+
+struct ColumnarHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t columnCount;
+    uint64_t rowCount;
+    uint64_t reserved;
+};
+
+struct ColumnarDescriptor {
+    char name[16];
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offsetsStart;   // int32 offsets buffer (UTF8 only)
+    uint64_t offsetsLength;
+    uint64_t dataStart;
+    uint64_t dataLength;
+};
+
+// A string column: offsets[i]..offsets[i+1] spans row i in data
+struct StringColumn {
+    std::vector<int32_t> offsets;
+    std::string data;
+
+    StringColumn() : offsets(1, 0) {}
+    void append(const std::string& value);
+    std::string at(size_t row) const;
+};
+
+// Output.txt rows (ID, name, course code, final grade) in column form
+struct ColumnarTable {
+    StringColumn studentID;
+    StringColumn studentName;
+    StringColumn courseCode;
+    std::vector<float> finalGrade;
+
+    size_t rowCount() const;
+};
+
+// Builds the table in the same order as Output.txt (sorted by student ID)
+ColumnarTable buildColumnarTable(const std::map<std::string, Student>& students, const GradeEngine* engine = nullptr);
+
+// Writes the table in large aligned blocks; throws FileAccessException
+void writeColumnarFile(const std::string& filename, const ColumnarTable& table);
+
+// Reads and validates a file written by writeColumnarFile; throws ColumnarFormatException
+ColumnarTable readColumnarFile(const std::string& filename);
+
+#endif
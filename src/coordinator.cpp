@@ -0,0 +1,234 @@
+#include "coordinator.h"
+#include "exceptions.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <cstdint>
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+extern std::string trim(const std::string&);
+
+Coordinator::Coordinator(unsigned workers, const std::string& executablePath, unsigned attempts)
+    : workerCount(workers < 1 ? 1 : workers), maxAttempts(attempts < 1 ? 1 : attempts), executable(executablePath) {}
+
+Coordinator::~Coordinator() {
+    if (!workDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::remove_all(workDirectory, error);
+    }
+}
+
+void Coordinator::setSchemesPath(const std::string& path) {
+    if (!path.empty()) {
+        addWorkerOption("--schemes", path);
+    }
+}
+
+void Coordinator::addWorkerOption(const std::string& option, const std::string& value) {
+    workerOptions.push_back(option);
+    if (!value.empty()) {
+        workerOptions.push_back(value);
+    }
+}
+
+const std::vector<WorkerShard>& Coordinator::getShards() const {
+    return shards;
+}
+
+// FNV-1a over the trimmed student ID, so every host computes the same shard
+size_t Coordinator::shardIndex(const std::string& line, unsigned count) {
+    std::string id = trim(line.substr(0, line.find(',')));
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : id) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash % count;
+}
+
+void Coordinator::partition(const std::string& nameFile, const std::string& courseFile) {
+    FileExceptionCheck(nameFile);
+    FileExceptionCheck(courseFile);
+
+    std::filesystem::path root = std::filesystem::temp_directory_path()
+#ifndef _WIN32
+                               / ("cp317-workers-" + std::to_string(getpid()));
+#else
+                               / "cp317-workers";
+#endif
+    std::filesystem::create_directories(root);
+    workDirectory = root.string();
+
+    shards.assign(workerCount, WorkerShard());
+    std::vector<std::ofstream> names(workerCount), courses(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        std::filesystem::path directory = root / ("shard-" + std::to_string(i));
+        std::filesystem::create_directories(directory);
+        shards[i].directory = directory.string();
+        names[i].open((directory / "NameFile.txt").string(), std::ios::trunc);
+        courses[i].open((directory / "CourseFile.txt").string(), std::ios::trunc);
+        std::ofstream((directory / "Output.txt").string(), std::ios::trunc);
+        if (!names[i].is_open() || !courses[i].is_open()) {
+            throw FileAccessException(shards[i].directory);
+        }
+    }
+
+    std::ifstream in(nameFile);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+        size_t shard = shardIndex(line, workerCount);
+        names[shard] << line << '\n';
+        shards[shard].nameRows++;
+    }
+
+    std::ifstream courseIn(courseFile);
+    while (std::getline(courseIn, line)) {
+        if (line.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+        size_t shard = shardIndex(line, workerCount);
+        courses[shard] << line << '\n';
+        shards[shard].courseRows++;
+    }
+
+    for (unsigned i = 0; i < workerCount; ++i) {
+        names[i].close();
+        courses[i].close();
+        if (!names[i] || !courses[i]) {
+            throw FileAccessException(shards[i].directory);
+        }
+    }
+}
+
+#ifndef _WIN32
+static pid_t launchWorker(const std::string& executable, const WorkerShard& shard, const std::vector<std::string>& options) {
+    std::vector<std::string> args = {executable, "--worker", "--input-dir", shard.directory,
+                                     "--output", shard.directory + "/Output.txt"};
+    args.insert(args.end(), options.begin(), options.end());
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        std::vector<char*> argv;
+        for (auto& arg : args) {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+        execv(executable.c_str(), argv.data());
+        _exit(127);
+    }
+    return pid;
+}
+#endif
+
+void Coordinator::runWorkers() {
+#ifdef _WIN32
+    std::cerr << "Warning: Worker processes are not supported on this platform" << std::endl;
+#else
+    std::map<pid_t, size_t> running;
+    auto start = [&](size_t index) {
+        shards[index].attempts++;
+        pid_t pid = launchWorker(executable, shards[index], workerOptions);
+        if (pid < 0) {
+            std::cerr << "Warning: Cannot start worker for " << shards[index].directory << std::endl;
+            return false;
+        }
+        running[pid] = index;
+        return true;
+    };
+
+    for (size_t i = 0; i < shards.size(); ++i) {
+        // Empty shards have nothing to report
+        shards[i].succeeded = shards[i].nameRows == 0;
+        if (!shards[i].succeeded) {
+            start(i);
+        }
+    }
+
+    while (!running.empty()) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            break;
+        }
+        auto it = running.find(pid);
+        if (it == running.end()) {
+            continue;
+        }
+        size_t index = it->second;
+        running.erase(it);
+
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            shards[index].succeeded = true;
+            continue;
+        }
+        std::cerr << "Warning: Worker " << index << " failed (attempt " << shards[index].attempts
+                  << " of " << maxAttempts << ")" << std::endl;
+        while (shards[index].attempts < maxAttempts && !start(index)) {}
+    }
+#endif
+}
+
+// Each partial output is sorted by student ID and no ID appears in two
+// shards, so a k-way merge on the ID column reproduces the single-process order
+bool Coordinator::mergeOutputs(const std::string& outputFile) const {
+    std::vector<std::ifstream> inputs;
+    for (const auto& shard : shards) {
+        if (shard.nameRows > 0) {
+            inputs.emplace_back(shard.directory + "/Output.txt");
+            if (!inputs.back().is_open()) {
+                throw FileAccessException(shard.directory + "/Output.txt");
+            }
+        }
+    }
+
+    typedef std::tuple<std::string, size_t, std::string> Row;   // student ID, input, line
+    std::priority_queue<Row, std::vector<Row>, std::greater<Row>> heads;
+    std::string line;
+    auto pull = [&](size_t input) {
+        if (std::getline(inputs[input], line)) {
+            heads.emplace(line.substr(0, line.find(',')), input, line);
+        }
+    };
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        pull(i);
+    }
+
+    std::ofstream out(outputFile, std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(outputFile);
+    }
+    while (!heads.empty()) {
+        size_t input = std::get<1>(heads.top());
+        out << std::get<2>(heads.top()) << '\n';
+        heads.pop();
+        pull(input);
+    }
+    out.close();
+    return static_cast<bool>(out);
+}
+
+bool Coordinator::run(const std::string& nameFile, const std::string& courseFile, const std::string& outputFile) {
+    partition(nameFile, courseFile);
+    std::cout << "Partitioned input into " << workerCount << " shards under " << workDirectory << std::endl;
+
+    runWorkers();
+
+    size_t failed = 0;
+    for (const auto& shard : shards) {
+        failed += shard.succeeded ? 0 : 1;
+    }
+    if (failed > 0) {
+        std::cerr << "Error: " << failed << " of " << workerCount << " workers failed after "
+                  << maxAttempts << " attempts" << std::endl;
+        return false;
+    }
+
+    FileExceptionCheck(outputFile);
+    return mergeOutputs(outputFile);
+}
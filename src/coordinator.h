@@ -0,0 +1,54 @@
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include <string>
+#include <vector>
+
+// One worker's share of the input, named by its directory. A worker is this
+// binary run as
+//
+//   <exe> --worker --input-dir <shard> --output <shard>/Output.txt [--schemes <config>] [options...]
+//
+// which is all a remote launcher would need to reproduce.
+struct WorkerShard {
+    std::string directory;
+    size_t nameRows;
+    size_t courseRows;
+    unsigned attempts;
+    bool succeeded;
+};
+
+// Scatter/gather over worker processes. Input rows are hashed by student ID
+// into one shard per worker, so every student and all of their courses land
+// in the same shard. Each worker writes an Output.txt sorted by student ID,
+// and the coordinator k-way merges those into the final file. A worker that
+// exits abnormally is started again, up to maxAttempts times.
+class Coordinator {
+    private:
+        unsigned workerCount;
+        unsigned maxAttempts;
+        std::string executable;
+        std::vector<std::string> workerOptions;   // appended to every worker's command line
+        std::string workDirectory;
+        std::vector<WorkerShard> shards;
+
+        static size_t shardIndex(const std::string& line, unsigned count);
+        void partition(const std::string& nameFile, const std::string& courseFile);
+        void runWorkers();
+        bool mergeOutputs(const std::string& outputFile) const;
+
+    public:
+        Coordinator(unsigned workers, const std::string& executablePath, unsigned attempts = 3);
+        ~Coordinator();
+
+        // Forwarded to every worker so Output.txt uses the same grading scheme
+        void setSchemesPath(const std::string& path);
+        // Any other option a worker applies to its own shard; value is omitted for flags
+        void addWorkerOption(const std::string& option, const std::string& value = "");
+
+        bool run(const std::string& nameFile, const std::string& courseFile, const std::string& outputFile);
+
+        const std::vector<WorkerShard>& getShards() const;
+};
+
+#endif
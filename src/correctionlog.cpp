@@ -0,0 +1,132 @@
+#include "correctionlog.h"
+#include "exceptions.h"
+#include <iostream>
+#include <fstream>
+
+extern std::string trim(const std::string&);
+extern std::vector<std::string> split(const std::string&, char);
+
+CorrectionLog::CorrectionLog() : fileName(""), appliedCount(0), rejectedCount(0) {}
+
+bool CorrectionLog::readLogFile(const std::string& filename) {
+    fileName = filename;
+    FileExceptionCheck(fileName);
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open file: " << fileName << std::endl;
+        return false;
+    }
+
+    corrections.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.find_first_not_of(" \t\r\n") == std::string::npos) {
+            continue;
+        }
+
+        std::vector<std::string> parts = split(line, ',');
+        if (parts.size() < 3) {
+            std::cerr << "Warning: Invalid format in " << fileName << " at line " << lineNumber
+                      << ": expected at least 3 fields, got " << parts.size() << std::endl;
+            continue;
+        }
+
+        Correction correction;
+        correction.lineNumber = lineNumber;
+        correction.studentID = trim(parts[0]);
+        correction.courseCode = trim(parts[1]);
+        correction.field = trim(parts[2]);
+        for (size_t i = 3; i < parts.size(); ++i) {
+            correction.values.push_back(trim(parts[i]));
+        }
+        corrections.push_back(correction);
+    }
+    return true;
+}
+
+void CorrectionLog::applyOne(const Correction& correction, Student& student) {
+    const std::string& field = correction.field;
+    size_t expectedValues = field == "insert" ? 4 : field == "delete" ? 0 : 1;
+    if (correction.values.size() != expectedValues) {
+        throw std::invalid_argument(field + " expects " + std::to_string(expectedValues) + " values, got "
+                                    + std::to_string(correction.values.size()));
+    }
+
+    if (field == "insert") {
+        Course course(correction.courseCode, std::stof(correction.values[0]), std::stof(correction.values[1]),
+                      std::stof(correction.values[2]), std::stof(correction.values[3]));
+        // addCourse reports a duplicate only after storing it; check first
+        if (student.hasCourse(correction.courseCode)) {
+            throw CourseAlreadyExists("Duplicate course found: " + correction.courseCode);
+        }
+        student.addCourse(course);
+        return;
+    }
+
+    if (field == "delete") {
+        if (!student.removeCourse(correction.courseCode)) {
+            throw std::invalid_argument("course " + correction.courseCode + " not found");
+        }
+        return;
+    }
+
+    Course* course = student.findCourse(correction.courseCode);
+    if (!course) {
+        throw std::invalid_argument("course " + correction.courseCode + " not found");
+    }
+    float value = std::stof(correction.values[0]);
+    if (field == "test1") course->setTest1(value);
+    else if (field == "test2") course->setTest2(value);
+    else if (field == "test3") course->setTest3(value);
+    else if (field == "finalExam") course->setFinalExam(value);
+    else throw std::invalid_argument("unknown field " + field);
+}
+
+std::set<std::string> CorrectionLog::apply(std::map<std::string, Student>& students) {
+    std::set<std::string> changed;
+    appliedCount = 0;
+    rejectedCount = 0;
+    for (const auto& correction : corrections) {
+        auto it = students.find(correction.studentID);
+        if (it == students.end()) {
+            std::cerr << "Warning: Student ID " << correction.studentID << " not found in NameFile.txt ("
+                      << fileName << " line " << correction.lineNumber << ")" << std::endl;
+            rejectedCount++;
+            continue;
+        }
+        try {
+            applyOne(correction, it->second);
+            changed.insert(correction.studentID);
+            appliedCount++;
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Error processing line " << correction.lineNumber
+                      << " in " << fileName << ": " << e.what() << std::endl;
+            rejectedCount++;
+        }
+    }
+    std::cout << "Applied " << appliedCount << " of " << corrections.size() << " corrections to "
+              << changed.size() << " students" << std::endl;
+    return changed;
+}
+
+std::set<std::string> CorrectionLog::getStudentIDs() const {
+    std::set<std::string> ids;
+    for (const auto& correction : corrections) {
+        ids.insert(correction.studentID);
+    }
+    return ids;
+}
+
+size_t CorrectionLog::getCorrectionCount() const {
+    return corrections.size();
+}
+
+size_t CorrectionLog::getAppliedCount() const {
+    return appliedCount;
+}
+
+size_t CorrectionLog::getRejectedCount() const {
+    return rejectedCount;
+}
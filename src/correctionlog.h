@@ -0,0 +1,52 @@
+#ifndef CORRECTIONLOG_H
+#define CORRECTIONLOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include "student.h"
+
+// Grade corrections applied to already-loaded students. One per line:
+//
+//   <student ID>, <course code>, test1|test2|test3|finalExam, <new grade>
+//   <student ID>, <course code>, insert, <test1>, <test2>, <test3>, <final exam>
+//   <student ID>, <course code>, delete
+//
+// Each change goes through Student::findCourse and the Course setters,
+// addCourse or removeCourse, so it is validated exactly like a loaded row.
+struct Correction {
+    int lineNumber;
+    std::string studentID;
+    std::string courseCode;
+    std::string field;
+    std::vector<std::string> values;
+};
+
+class CorrectionLog {
+    private:
+        std::string fileName;
+        std::vector<Correction> corrections;
+        size_t appliedCount;
+        size_t rejectedCount;
+
+        static void applyOne(const Correction& correction, Student& student);
+
+    public:
+        CorrectionLog();
+
+        // Returns false if the file cannot be read; malformed lines are skipped with a warning
+        bool readLogFile(const std::string& filename);
+
+        // Applies every correction in order and returns the IDs of students that changed
+        std::set<std::string> apply(std::map<std::string, Student>& students);
+
+        // Every student the log names, so only those need to be read
+        std::set<std::string> getStudentIDs() const;
+
+        size_t getCorrectionCount() const;
+        size_t getAppliedCount() const;
+        size_t getRejectedCount() const;
+};
+
+#endif
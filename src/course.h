@@ -2,6 +2,8 @@
 #define COURSE_H
 
 #include <string>
+#include <cstdint>
+#include <atomic>
 #include "exceptions.h"
 
 // ENCAPSULATION: Course class with private data and controlled access
@@ -9,15 +11,29 @@ class Course {
 private:
     std::string courseCode;
     float test1, test2, test3, finalExam;
+
+    // Memoized final grade. gradeState counts grade changes above bit 0,
+    // which is set while cachedFinalGrade is current. Both are atomic, so
+    // threads may share a const Course with a cold cache; the setters and
+    // assignments still need the caller to keep other threads out.
+    mutable std::atomic<float> cachedFinalGrade;
+    mutable std::atomic<uint32_t> gradeState;
     
 public:
     // Constructors
     Course();
     Course(const std::string& code, float t1, float t2, float t3, float exam);
     
+    // For rows that already passed BulkValidator; skips the per-object checks
+    static Course createValidated(const std::string& code, float t1, float t2, float t3, float exam);
+    
     // Copy constructor and assignment operator
     Course(const Course& other);
     Course& operator=(const Course& other);
+
+    // Moves take the code's buffer instead of copying it
+    Course(Course&& other) noexcept;
+    Course& operator=(Course&& other) noexcept;
     
     // Destructor
     ~Course() = default;
@@ -25,9 +41,17 @@ public:
     // PROJECT REQUIREMENT: Grade calculation
     // Formula: (Test1 + Test2 + Test3) × 20% + FinalExam × 40%
     float calculateFinalGrade() const;
+
+    // Rises with every grade change, assignment included, so a Student can
+    // tell that a course changed through a pointer it handed out
+    uint32_t getVersion() const;
+
+    // Final grade cache counters of this thread and of finished threads
+    static unsigned long getCacheHits();
+    static unsigned long getCacheMisses();
     
     // Getters with validation
-    std::string getCourseCode() const;
+    const std::string& getCourseCode() const;
     float getTest1() const;
     float getTest2() const;
     float getTest3() const;
@@ -51,6 +75,8 @@ public:
     std::string toString() const;
     
 private:
+    void assignCache(const Course& other);
+
     // Validation methods
     void validateInputs(const std::string& code, float t1, float t2, float t3, float exam) const;
 };
@@ -0,0 +1,279 @@
+#include "dataset.h"
+#include "filereader.h"
+#include "exceptions.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+extern std::string trim(const std::string&);
+extern std::vector<std::string> split(const std::string&, char);
+
+static const char* NAME_FILE = "NameFile.txt";
+static const char* COURSE_FILE = "CourseFile.txt";
+static const char* METADATA_FILE = "partition.meta";
+
+PartitionMetadata::PartitionMetadata()
+    : nameRows(0), courseRows(0), nameFileSize(0), courseFileSize(0), nameFileTime(0), courseFileTime(0), stale(false) {}
+
+bool DatasetQuery::matchesStudent(std::string_view studentID) const {
+    if (!minStudentID.empty() && studentID < minStudentID) return false;
+    if (!maxStudentID.empty() && studentID > maxStudentID) return false;
+    return true;
+}
+
+bool DatasetQuery::matchesCourse(std::string_view courseCode) const {
+    if (courseCodes.empty() || courseCodes.count(courseCode) > 0) {
+        return true;
+    }
+    for (const auto& code : courseCodes) {
+        size_t prefix = code.size() - 1;
+        if (!code.empty() && code.back() == '*' && courseCode.compare(0, prefix, code, 0, prefix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DatasetQuery::filtersRows() const {
+    return !courseCodes.empty() || !minStudentID.empty() || !maxStudentID.empty();
+}
+
+Dataset::Dataset(const std::string& rootDirectory) : root(rootDirectory), skippedCount(0) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(root, error)) {
+        throw FileNotFoundException(root);
+    }
+
+    std::vector<std::string> terms;
+    for (const auto& entry : std::filesystem::directory_iterator(root)) {
+        if (entry.is_directory() && std::filesystem::exists(entry.path() / NAME_FILE)
+                                 && std::filesystem::exists(entry.path() / COURSE_FILE)) {
+            terms.push_back(entry.path().filename().string());
+        }
+    }
+    std::sort(terms.begin(), terms.end());
+
+    // Stale metadata is not rebuilt here: that would load every such
+    // partition, including ones the query prunes by term
+    for (const auto& term : terms) {
+        partitions.push_back(loadMetadata(term));
+    }
+    std::cout << "Dataset " << root << " has " << partitions.size() << " term partitions" << std::endl;
+}
+
+std::string Dataset::termPath(const std::string& term) const {
+    return (std::filesystem::path(root) / term).string();
+}
+
+void Dataset::readSourceStats(const std::string& term, PartitionMetadata& metadata) const {
+    std::filesystem::path directory(termPath(term));
+    metadata.nameFileSize = std::filesystem::file_size(directory / NAME_FILE);
+    metadata.courseFileSize = std::filesystem::file_size(directory / COURSE_FILE);
+    metadata.nameFileTime = std::filesystem::last_write_time(directory / NAME_FILE).time_since_epoch().count();
+    metadata.courseFileTime = std::filesystem::last_write_time(directory / COURSE_FILE).time_since_epoch().count();
+}
+
+PartitionMetadata Dataset::loadMetadata(const std::string& term) const {
+    PartitionMetadata current;
+    readSourceStats(term, current);
+
+    PartitionMetadata metadata;
+    metadata.term = term;
+    std::ifstream file((std::filesystem::path(termPath(term)) / METADATA_FILE).string());
+    std::string line;
+    while (file.is_open() && std::getline(file, line)) {
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        try {
+            if (key == "minStudentID") metadata.minStudentID = value;
+            else if (key == "maxStudentID") metadata.maxStudentID = value;
+            else if (key == "nameRows") metadata.nameRows = std::stoul(value);
+            else if (key == "courseRows") metadata.courseRows = std::stoul(value);
+            else if (key == "nameFileSize") metadata.nameFileSize = std::stoull(value);
+            else if (key == "courseFileSize") metadata.courseFileSize = std::stoull(value);
+            else if (key == "nameFileTime") metadata.nameFileTime = std::stoll(value);
+            else if (key == "courseFileTime") metadata.courseFileTime = std::stoll(value);
+            else if (key == "courseCodes") {
+                for (const auto& code : split(value, ',')) {
+                    if (!trim(code).empty()) metadata.courseCodes.insert(trim(code));
+                }
+            }
+        } catch (const std::exception&) {
+            metadata.nameFileSize = 0;   // unreadable value, treat as stale
+        }
+    }
+
+    bool fresh = file.is_open() && metadata.nameFileSize == current.nameFileSize
+              && metadata.courseFileSize == current.courseFileSize
+              && metadata.nameFileTime == current.nameFileTime
+              && metadata.courseFileTime == current.courseFileTime;
+    if (fresh) {
+        return metadata;
+    }
+
+    current.term = term;
+    current.stale = true;
+    return current;
+}
+
+// A term that fails to load is an error, as a failed NameFile.txt or
+// CourseFile.txt is in a single-term run
+void Dataset::loadPartition(const std::string& term, std::map<std::string, Student>& students) const {
+    std::filesystem::path directory(termPath(term));
+    FileReader nameFile((directory / NAME_FILE).string());
+    if (!nameFile.readNameFile(students)) {
+        throw FileException("Failed to read " + nameFile.getFileName());
+    }
+    FileReader courseFile((directory / COURSE_FILE).string());
+    if (!courseFile.readCourseFile(students)) {
+        throw FileException("Failed to read " + courseFile.getFileName());
+    }
+}
+
+// Fills in everything but the term and source stats, which were read before the load
+void Dataset::summarizePartition(const std::map<std::string, Student>& students, PartitionMetadata& metadata) {
+    metadata.nameRows = students.size();
+    if (!students.empty()) {
+        metadata.minStudentID = students.begin()->first;
+        metadata.maxStudentID = students.rbegin()->first;
+    }
+    for (const auto& [id, student] : students) {
+        metadata.courseRows += student.getCourseCount();
+        for (const auto& course : student.getCourses()) {
+            metadata.courseCodes.insert(course.getCourseCode());
+        }
+    }
+    metadata.stale = false;
+}
+
+void Dataset::saveMetadata(const PartitionMetadata& metadata) const {
+    std::ofstream file((std::filesystem::path(termPath(metadata.term)) / METADATA_FILE).string(), std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Cannot write metadata for term " << metadata.term << std::endl;
+        return;
+    }
+    file << "term=" << metadata.term << "\n"
+         << "minStudentID=" << metadata.minStudentID << "\n"
+         << "maxStudentID=" << metadata.maxStudentID << "\n"
+         << "nameRows=" << metadata.nameRows << "\n"
+         << "courseRows=" << metadata.courseRows << "\n"
+         << "nameFileSize=" << metadata.nameFileSize << "\n"
+         << "courseFileSize=" << metadata.courseFileSize << "\n"
+         << "nameFileTime=" << metadata.nameFileTime << "\n"
+         << "courseFileTime=" << metadata.courseFileTime << "\n"
+         << "courseCodes=";
+    bool first = true;
+    for (const auto& code : metadata.courseCodes) {
+        file << (first ? "" : ",") << code;
+        first = false;
+    }
+    file << "\n";
+}
+
+const std::vector<PartitionMetadata>& Dataset::getPartitions() const {
+    return partitions;
+}
+
+size_t Dataset::getSkippedCount() const {
+    return skippedCount;
+}
+
+bool Dataset::canSkip(const PartitionMetadata& metadata, const DatasetQuery& query) {
+    if (!query.terms.empty() && query.terms.count(metadata.term) == 0) {
+        return true;
+    }
+    if (metadata.stale) {
+        return false;
+    }
+    if (metadata.nameRows == 0) {
+        return true;
+    }
+    if (!query.minStudentID.empty() && metadata.maxStudentID < query.minStudentID) {
+        return true;
+    }
+    if (!query.maxStudentID.empty() && metadata.minStudentID > query.maxStudentID) {
+        return true;
+    }
+    if (!query.courseCodes.empty()) {
+        bool overlap = std::any_of(metadata.courseCodes.begin(), metadata.courseCodes.end(),
+            [&query](const std::string& code) { return query.matchesCourse(code); });
+        if (!overlap) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<TermPartition> Dataset::load(const DatasetQuery& query, unsigned threadCount) {
+    std::vector<TermPartition> selected;
+    std::vector<size_t> sources;   // index in partitions of each selected one
+    skippedCount = 0;
+    for (size_t p = 0; p < partitions.size(); ++p) {
+        if (canSkip(partitions[p], query)) {
+            skippedCount++;
+            continue;
+        }
+        if (partitions[p].stale) {
+            std::cout << "Building partition metadata for term " << partitions[p].term << std::endl;
+        }
+        TermPartition partition;
+        partition.metadata = partitions[p];
+        selected.push_back(std::move(partition));
+        sources.push_back(p);
+    }
+    std::cout << "Loading " << selected.size() << " of " << partitions.size()
+              << " term partitions (" << skippedCount << " skipped)" << std::endl;
+
+    // Independent partitions load on a pool of worker threads
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    std::atomic<size_t> next(0);
+    std::vector<std::string> errors(selected.size());
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount && t < selected.size(); ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < selected.size(); i = next++) {
+                try {
+                    loadPartition(selected[i].metadata.term, selected[i].students);
+                    if (selected[i].metadata.stale) {
+                        summarizePartition(selected[i].students, selected[i].metadata);
+                        saveMetadata(selected[i].metadata);
+                    }
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t i = 0; i < selected.size(); ++i) {
+        if (!errors[i].empty()) {
+            throw FileException("term " + selected[i].metadata.term + ": " + errors[i]);
+        }
+    }
+
+    // Rebuilt partitions are pruned now that their metadata is known
+    std::vector<TermPartition> kept;
+    for (size_t i = 0; i < selected.size(); ++i) {
+        if (partitions[sources[i]].stale) {
+            partitions[sources[i]] = selected[i].metadata;
+            if (canSkip(selected[i].metadata, query)) {
+                skippedCount++;
+                continue;
+            }
+        }
+        kept.push_back(std::move(selected[i]));
+    }
+    return kept;
+}
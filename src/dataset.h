@@ -0,0 +1,90 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <map>
+#include <cstdint>
+#include "student.h"
+
+// Multi-term dataset: one directory per term, each a separately loadable
+// partition with its own metadata file.
+//
+//   <root>/<term>/NameFile.txt
+//   <root>/<term>/CourseFile.txt
+//   <root>/<term>/partition.meta    (written on first load, rebuilt when stale)
+
+struct PartitionMetadata {
+    std::string term;
+    std::string minStudentID;
+    std::string maxStudentID;
+    size_t nameRows;
+    size_t courseRows;
+    std::set<std::string> courseCodes;
+
+    // Source file sizes and times, used to detect a stale partition.meta
+    uintmax_t nameFileSize;
+    uintmax_t courseFileSize;
+    long long nameFileTime;
+    long long courseFileTime;
+
+    // partition.meta was missing or out of date; only the term and source
+    // stats are known until the partition is loaded and its metadata rebuilt
+    bool stale;
+
+    PartitionMetadata();
+};
+
+// Subset of the dataset a report covers; empty fields match everything.
+// A course code ending in '*' selects every code with that prefix (CP*)
+struct DatasetQuery {
+    std::set<std::string> terms;
+    std::set<std::string, std::less<>> courseCodes;
+    std::string minStudentID;
+    std::string maxStudentID;
+
+    bool matchesStudent(std::string_view studentID) const;
+    bool matchesCourse(std::string_view courseCode) const;
+
+    // True when the ID range or course codes leave some rows out
+    bool filtersRows() const;
+};
+
+struct TermPartition {
+    PartitionMetadata metadata;
+    std::map<std::string, Student> students;
+};
+
+class Dataset {
+    private:
+        std::string root;
+        std::vector<PartitionMetadata> partitions;
+        size_t skippedCount;
+
+        std::string termPath(const std::string& term) const;
+        PartitionMetadata loadMetadata(const std::string& term) const;
+        static void summarizePartition(const std::map<std::string, Student>& students, PartitionMetadata& metadata);
+        void saveMetadata(const PartitionMetadata& metadata) const;
+        // Throws FileException when either file yields nothing
+        void loadPartition(const std::string& term, std::map<std::string, Student>& students) const;
+        void readSourceStats(const std::string& term, PartitionMetadata& metadata) const;
+
+    public:
+        Dataset(const std::string& rootDirectory);
+
+        const std::vector<PartitionMetadata>& getPartitions() const;
+        size_t getSkippedCount() const;
+
+        // Decided from partition.meta alone; the data files are never opened.
+        // A stale partition can only be skipped by term
+        static bool canSkip(const PartitionMetadata& metadata, const DatasetQuery& query);
+
+        // Loads every partition the query needs, in parallel, ordered by term.
+        // Stale metadata is rebuilt from the loaded rows and saved, and a
+        // partition the rebuilt metadata prunes is dropped from the result
+        std::vector<TermPartition> load(const DatasetQuery& query, unsigned threadCount);
+};
+
+#endif
@@ -30,7 +30,7 @@ void CourseCodeExceptionCheck(const std::string& code) { //handles all main cour
     std::cout << "Course is valid and has been checked successfully. \n";
 }
 
-void CourseStudentExceptionCheck(const Student& student) { //handles student course exceptions
+void CourseEnrollmentExceptionCheck(const Student& student) { //course count and duplicate checks only
     if (student.getCourseCount() > 10)
         throw CheckMaxCourses("Limit Reached for student (" + student.getStudentID() + ")");
 
@@ -43,8 +43,12 @@ void CourseStudentExceptionCheck(const Student& student) { //handles student cou
             }
         }
     }
+}
+
+void CourseStudentExceptionCheck(const Student& student) { //handles student course exceptions
+    CourseEnrollmentExceptionCheck(student);
 
-    for (Course course : student.getCourses()) {
+    for (const Course& course : student.getCourses()) {
         if (course.getTest1() < 0 || course.getTest1() > 100)
             throw CourseInvalidGrade(course.getCourseCode());
         if (course.getTest2() < 0 || course.getTest2() > 100)
@@ -77,12 +81,13 @@ void SingleGradeExceptionCheck (const float score){
     std::cout << "The grade has been checked and verified successfully. \n";
 }
 
-void ValidStudentExceptionCheck(const Student& student) { //handles student id exceptions
+void ValidStudentExceptionCheck(const Student& student, bool quiet) { //handles student id exceptions
     if (student.getStudentID().length() != 9) 
         throw ValidateStudentID("The student " + student.getStudentName());
 
     if (student.getStudentName().empty() || student.getStudentName().length() > 100) 
         throw ValidateName("Student name with ID: " + student.getStudentID());
 
-    std::cout << "The student has been checked and verified successfully. \n";
+    if (!quiet)
+        std::cout << "The student has been checked and verified successfully. \n";
 }
\ No newline at end of file
@@ -34,6 +34,31 @@ class FileAccessException : public FileException { //cannot access file
         explicit FileAccessException(const std::string& filename): FileException("Cannot access file: " + filename) {}
 };
 
+class ColumnarFormatException : public FileException { //columnar output file is malformed
+    public:
+        explicit ColumnarFormatException(const std::string& message): FileException("Invalid columnar file: " + message) {}
+};
+
+class TranscriptArchiveException : public FileException { //transcript archive is truncated or malformed
+    public:
+        explicit TranscriptArchiveException(const std::string& message): FileException("Invalid transcript archive: " + message) {}
+};
+
+class UnsortedInputException : public FileException { //input is not sorted by student ID
+    public:
+        explicit UnsortedInputException(const std::string& message): FileException("Input not sorted by student ID: " + message) {}
+};
+
+class SharedMemoryException : public FileException { //shared-memory dataset missing or malformed
+    public:
+        explicit SharedMemoryException(const std::string& message): FileException("Shared dataset: " + message) {}
+};
+
+class CompressionException : public FileException { //compressed output could not be produced
+    public:
+        explicit CompressionException(const std::string& message): FileException("Compression failed: " + message) {}
+};
+
 //COURSE EXCEPTIONS 
 class CourseException : public ProjectException { //General course exception 
     public:
@@ -66,6 +91,17 @@ class ValidGrade: public ProjectException{
         explicit ValidGrade(const std::string& message): ProjectException("Grade is invalid: " + message) {}
 };
 
+class GradeSchemeException: public ProjectException{ //grading scheme config is invalid
+    public:
+        explicit GradeSchemeException(const std::string& message): ProjectException("Grading scheme is invalid: " + message) {}
+};
+
+//MEMORY EXCEPTIONS
+class MemoryBudgetException : public ProjectException { //a load would not fit the memory budget
+    public:
+        explicit MemoryBudgetException(const std::string& message): ProjectException("Memory budget exceeded: " + message) {}
+};
+
 //STUDENT EXCEPTIONS 
 class ValidateStudentID : public ProjectException { //invalid student id 
     public: 
@@ -80,8 +116,9 @@ class ValidateName : public ProjectException { //invalid student name
 void FileExceptionCheck(const std::string& filename);
 void CourseCodeExceptionCheck(const std::string& code);
 void CourseStudentExceptionCheck(const Student& student);
+void CourseEnrollmentExceptionCheck(const Student& student);
 void GradeExceptionCheck(const float t1, float t2, float t3, float exam);
 void SingleGradeExceptionCheck(const float score);
-void ValidStudentExceptionCheck(const Student& student);
+void ValidStudentExceptionCheck(const Student& student, bool quiet = false);   //quiet skips the success message
 
 #endif
\ No newline at end of file
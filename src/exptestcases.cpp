@@ -1,19 +1,89 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <new>
+#include <filesystem>
+#include <future>
 #include "filewriter.h"
 #include "filereader.h"
 #include "exceptions.h"
 #include "student.h"
+#include "inlinevector.h"
 #include "course.h"
+#include "columnar.h"
+#include "gradeengine.h"
+#include "transcriptwriter.h"
+#include "bloomfilter.h"
+#include "bulkvalidation.h"
+#include "samplepreview.h"
+#include "coordinator.h"
+#include "correctionlog.h"
+#include "outputmanifest.h"
+#include "outputsnapshot.h"
+#include "nameindex.h"
+#include "shareddataset.h"
+#include "rowindex.h"
+#include "memoryaccount.h"
+#include "stageprofiler.h"
+#include "recordschema.h"
+#include "dataset.h"
+#include "mergejoin.h"
+#include "checkpoint.h"
+#include "ranking.h"
+#include "gzipblock.h"
+#include <zlib.h>
 
 // Function prototypes
 std::vector<std::string> split(const std::string& str, char delimiter);
 std::string trim(const std::string& str);
 
+// Every heap allocation in the test program, for the hot path checks
+static std::atomic<size_t> allocationCount(0);
+
+static const size_t HEADER = sizeof(std::max_align_t);
+
+void* operator new(size_t size) {
+    void* block = std::malloc(size + HEADER);
+    if (!block) throw std::bad_alloc();
+    allocationCount++;
+    return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(block) + HEADER);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    std::free(reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(pointer) - HEADER));
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+// std::stable_sort's buffer comes from the nothrow form; it must carry the same header
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    operator delete(pointer);
+}
+
 void testFileExceptionCheck(){
     std::cout<<"--------TESTING FILE EXCEPTION CHECK--------"<<std::endl;
     std::cout<<"\n";
@@ -258,6 +328,1863 @@ void testValidStudentExceptionCheck(){
     std::cout<<"\n";
 }
 
+// Everything in a file, byte for byte
+static std::string readWholeFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void testColumnarRoundTrip(){
+    std::cout<<"--------TESTING COLUMNAR OUTPUT--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::map<std::string, Student> students;
+    students["222222222"] = Student("222222222", "Bob Marley");
+    students["111111111"] = Student("111111111", "Alice King");
+    students["111111111"].addCourse(Course("CP317", 55, 96, 75, 95));
+    students["111111111"].addCourse(Course("MA200", 63, 82, 58, 68));
+    students["222222222"].addCourse(Course("BU111", 58, 98, 56, 89));
+
+    std::string filename = "columnar_test.bin";
+
+    std::cout<<"--------Testing Round Trip--------"<<std::endl;
+    try{
+        FileWriter writer;
+        writer.setFileName(filename);
+        writer.writeColumnarFile(students);
+        ColumnarTable table = readColumnarFile(filename);
+
+        bool match = table.rowCount() == 3;
+        int row = 0;
+        for (const auto& [id, student] : students) {
+            for (const auto& course : student.getCourses()) {
+                match = match && table.studentID.at(row) == id
+                              && table.studentName.at(row) == student.getStudentName()
+                              && table.courseCode.at(row) == course.getCourseCode()
+                              && table.finalGrade[row] == course.calculateFinalGrade();
+                row++;
+            }
+        }
+        if (match)
+            std::cout<<"PASS: Columnar file matches the student map"<<std::endl;
+        else
+            std::cout<<"FAIL: Columnar file does not match the student map"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"\n";
+    std::cout<<"--------Testing Huge Header Sizes--------"<<std::endl;
+    // A row count and a buffer length that would allocate terabytes or wrap start + length
+    std::string intact = readWholeFile(filename);
+    for (int damage = 0; damage < 2; ++damage) {
+        std::string bytes = intact;
+        if (damage == 0) {
+            uint64_t rows = uint64_t(1) << 60;
+            std::memcpy(&bytes[offsetof(ColumnarHeader, rowCount)], &rows, sizeof(rows));
+        } else {
+            ColumnarDescriptor name;
+            size_t at = sizeof(ColumnarHeader) + sizeof(ColumnarDescriptor);
+            std::memcpy(&name, &bytes[at], sizeof(name));
+            name.dataLength = ~uint64_t(0) - name.dataStart + 2;
+            std::memcpy(&bytes[at], &name, sizeof(name));
+        }
+        std::ofstream(filename, std::ios::binary | std::ios::trunc)<<bytes;
+        try{
+            readColumnarFile(filename);
+            std::cout<<"FAIL: Damaged header was accepted"<<std::endl;
+        }
+        catch(const ColumnarFormatException& e){
+            std::cout<<"PASS: Caught expected ColumnarFormatException "<<e.what()<<std::endl;
+        }
+        catch(const std::exception& e){
+            std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+        }
+    }
+    std::ofstream(filename, std::ios::binary | std::ios::trunc)<<intact;
+
+    std::cout<<"\n";
+    std::cout<<"--------Testing Truncated File--------"<<std::endl;
+    truncate(filename.c_str(), 1000);
+    try{
+        readColumnarFile(filename);
+        std::cout<<"FAIL: Truncated file was accepted"<<std::endl;
+    }
+    catch(const ColumnarFormatException& e){
+        std::cout<<"PASS: Caught expected ColumnarFormatException "<<e.what()<<std::endl;
+    }
+    catch(...){
+        std::cout<<"FAIL: Caught unexpected error"<<std::endl;
+    }
+    remove(filename.c_str());
+
+    std::cout<<"\n";
+}
+
+void testParallelWriter(){
+    std::cout<<"--------TESTING PARALLEL WRITER--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Parallel Output Matches Sequential Output--------"<<std::endl;
+    // Uneven course counts, including students with none, so partitions differ in size
+    std::map<std::string, Student> students;
+    const char* codes[] = {"CP317", "MA200", "BU111", "ST259", "PS101"};
+    for (int s = 0; s < 200; ++s) {
+        std::string id = std::to_string(300000000 + s * 7);
+        students[id] = Student(id, "Student Number");
+        for (int c = 0; c < s % 6 && c < 5; ++c) {
+            students[id].addCourse(Course(codes[c], (s * 13) % 101, (s * 7) % 101, 50.5f, (s + c) % 101));
+        }
+    }
+
+    try{
+        std::ofstream("parallel_plain.txt").close();
+        std::ofstream("parallel_output.txt").close();
+        FileWriter plain("parallel_plain.txt");
+        plain.writeOutputFile(students);
+        std::string expected = readWholeFile("parallel_plain.txt");
+
+        bool identical = !expected.empty();
+        for (unsigned threads : {1u, 2u, 3u, 7u, 500u}) {
+            FileWriter parallel("parallel_output.txt");
+            parallel.writeOutputFileParallel(students, threads);
+            identical = identical && readWholeFile("parallel_output.txt") == expected;
+        }
+        if (identical)
+            std::cout<<"PASS: Every thread count writes the same bytes as writeOutputFile"<<std::endl;
+        else
+            std::cout<<"FAIL: Parallel output differs from writeOutputFile"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("parallel_plain.txt");
+    remove("parallel_output.txt");
+
+    std::cout<<"\n";
+}
+
+void testGradeEngineDefault(){
+    std::cout<<"--------TESTING GRADE ENGINE--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Default Scheme Is Bit-Exact--------"<<std::endl;
+    GradeEngine engine;
+    int mismatches = 0;
+    for (float t = 0; t <= 100; t += 2.5f){
+        for (float exam = 0; exam <= 100; exam += 0.5f){
+            Course course ("CP317", t, 100 - t, t / 2, exam);
+            float expected = course.calculateFinalGrade();
+            float actual = engine.calculateFinalGrade(course);
+            if (std::memcmp(&expected, &actual, sizeof(float)) != 0)
+                mismatches++;
+        }
+    }
+    if (mismatches == 0)
+        std::cout<<"PASS: Default scheme matches Course::calculateFinalGrade"<<std::endl;
+    else
+        std::cout<<"FAIL: "<<mismatches<<" grades differ from Course::calculateFinalGrade"<<std::endl;
+
+    std::cout<<"\n";
+}
+
+void testGradeCacheInvalidation(){
+    std::cout<<"--------TESTING GRADE CACHE--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Setter Invalidates Final Grade--------"<<std::endl;
+    Course course ("CP317", 55, 96, 75, 95);
+    float before = course.calculateFinalGrade();
+    unsigned long hits = Course::getCacheHits();
+    course.calculateFinalGrade();
+    course.setFinalExam(45);
+    Course fresh ("CP317", 55, 96, 75, 45);
+    if (Course::getCacheHits() == hits + 1 && course.calculateFinalGrade() == fresh.calculateFinalGrade() && before != fresh.calculateFinalGrade())
+        std::cout<<"PASS: Cached grade reused, then recomputed after setFinalExam"<<std::endl;
+    else
+        std::cout<<"FAIL: Cached final grade is stale"<<std::endl;
+
+    std::cout<<"\n";
+    std::cout<<"--------Testing Course Changes Invalidate Average--------"<<std::endl;
+    Student s ("123456789", "Alice King");
+    s.addCourse(Course("CP317", 50, 50, 50, 50));
+    float first = s.getOverallAverage();
+    s.addCourse(Course("MA200", 100, 100, 100, 100));
+    float added = s.getOverallAverage();
+    s.findCourse("MA200")->setTest1(0);
+    float edited = s.getOverallAverage();
+    s.removeCourse("MA200");
+    float removed = s.getOverallAverage();
+    if (first == 50 && added == 75 && edited == 65 && removed == 50)
+        std::cout<<"PASS: Average follows addCourse, setters and removeCourse"<<std::endl;
+    else
+        std::cout<<"FAIL: Cached average is stale"<<std::endl;
+
+    std::cout<<"\n";
+    std::cout<<"--------Testing A Kept Course Pointer Invalidates Average--------"<<std::endl;
+    Student kept ("123456789", "Alice King");
+    kept.addCourse(Course("CP317", 50, 50, 50, 50));
+    kept.addCourse(Course("MA200", 100, 100, 100, 100));
+    Course* course200 = kept.findCourse("MA200");
+    float beforeEdit = kept.getOverallAverage();
+    course200->setTest1(0);
+    float afterSetter = kept.getOverallAverage();
+    *course200 = Course("MA200", 100, 100, 100, 100);
+    float afterAssign = kept.getOverallAverage();
+    if (beforeEdit == 75 && afterSetter == 65 && afterAssign == 75)
+        std::cout<<"PASS: Average follows changes made through a pointer kept from findCourse"<<std::endl;
+    else
+        std::cout<<"FAIL: Average is stale after a change through a kept pointer"<<std::endl;
+
+    std::cout<<"\n";
+    std::cout<<"--------Testing Cache Counters Across Threads--------"<<std::endl;
+    Course shared ("CP317", 55, 96, 75, 95);
+    shared.calculateFinalGrade();
+    unsigned long hitsBefore = Course::getCacheHits();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&shared]() {
+            for (int i = 0; i < 1000; ++i) {
+                shared.calculateFinalGrade();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (Course::getCacheHits() == hitsBefore + 4000)
+        std::cout<<"PASS: Hits counted on worker threads are in the total once they finish"<<std::endl;
+    else
+        std::cout<<"FAIL: Hits counted on worker threads are missing from the total"<<std::endl;
+
+    std::cout<<"\n";
+    std::cout<<"--------Testing Cold Caches Shared Between Threads--------"<<std::endl;
+    // Every thread may be the one to fill the caches; all must read the same values
+    const Student cold = [] {
+        Student student("111111111", "Alice King");
+        student.addCourse(Course("CP317", 55, 96, 75, 95));
+        student.addCourse(Course("MA200", 63, 82, 58, 68));
+        return student;
+    }();
+    float expectedAverage = Student(cold).getOverallAverage();
+    std::vector<float> averages(4), grades(4);
+    workers.clear();
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&cold, &averages, &grades, t]() {
+            grades[t] = cold.getCourses()[1].calculateFinalGrade();
+            averages[t] = cold.getOverallAverage();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    bool agree = true;
+    for (int t = 0; t < 4; ++t) {
+        agree = agree && averages[t] == expectedAverage && grades[t] == cold.getCourses()[1].calculateFinalGrade();
+    }
+    if (agree)
+        std::cout<<"PASS: Threads filling the same cold caches read one average"<<std::endl;
+    else
+        std::cout<<"FAIL: Threads read different averages from shared caches"<<std::endl;
+
+    std::cout<<"\n";
+}
+
+void testTranscriptArchive(){
+    std::cout<<"--------TESTING TRANSCRIPTS--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::map<std::string, Student> students;
+    students["111111111"] = Student("111111111", "Alice King");
+    students["111111111"].addCourse(Course("CP317", 55, 96, 75, 95));
+    students["111111111"].addCourse(Course("MA200", 63, 82, 58, 68));
+    students["222222222"] = Student("222222222", "Bob Marley");
+    students["333333333"] = Student("333333333", "Freddie Mercury");
+    students["333333333"].addCourse(Course("BU111", 58, 98, 56, 89));
+
+    std::cout<<"--------Testing Archive Matches toString and getGradeSummary--------"<<std::endl;
+    std::string filename = "transcripts_test.dat";
+    try{
+        TranscriptWriter writer(2);
+        writer.writeArchive(students, filename);
+        bool match = true;
+        for (const auto& [id, student] : students) {
+            std::string expected = student.toString() + student.getGradeSummary() + "\n";
+            match = match && TranscriptWriter::readArchiveEntry(filename, id) == expected;
+        }
+        match = match && TranscriptWriter::readArchiveEntry(filename, "999999999").empty();
+        if (match)
+            std::cout<<"PASS: Archived transcripts match the Student text"<<std::endl;
+        else
+            std::cout<<"FAIL: Archived transcripts differ from the Student text"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing Corrupt Archives--------"<<std::endl;
+    // Each damaged copy must throw instead of allocating or returning short text
+    std::string intact = readWholeFile(filename);
+    std::string damaged = intact;
+    uint64_t hugeLength = uint64_t(1) << 63;
+    std::memcpy(&damaged[sizeof(TranscriptArchiveHeader) + offsetof(TranscriptIndexEntry, length)], &hugeLength, sizeof(hugeLength));
+    std::string hugeCount = intact;
+    uint64_t count = uint64_t(1) << 60;
+    std::memcpy(&hugeCount[offsetof(TranscriptArchiveHeader, count)], &count, sizeof(count));
+    std::vector<std::string> corrupt = {damaged, hugeCount, intact.substr(0, intact.size() - 10)};
+    int rejected = 0;
+    for (const auto& bytes : corrupt) {
+        std::ofstream(filename, std::ios::binary | std::ios::trunc) << bytes;
+        try{
+            TranscriptWriter::readArchiveEntry(filename, "333333333");
+            TranscriptWriter::readArchiveEntry(filename, "111111111");
+        }
+        catch(const TranscriptArchiveException&){
+            rejected++;
+        }
+        catch(const std::exception& e){
+            std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+        }
+    }
+    if (rejected == 3)
+        std::cout<<"PASS: Oversized lengths, counts and truncated archives are rejected"<<std::endl;
+    else
+        std::cout<<"FAIL: Only "<<rejected<<" of 3 corrupt archives were rejected"<<std::endl;
+    remove(filename.c_str());
+
+    std::cout<<"--------Testing Shard Paths--------"<<std::endl;
+    // The last three digits vary within a leaf, so a leaf holds at most 1000 transcripts
+    if (TranscriptWriter::shardPath("out", "123456789") == "out/123/456/123456789.txt"
+        && TranscriptWriter::shardPath("out", "123456000") == "out/123/456/123456000.txt"
+        && TranscriptWriter::shardPath("out", "12") == "out/_/_/12.txt")
+        std::cout<<"PASS: Transcripts are sharded three digits per level"<<std::endl;
+    else
+        std::cout<<"FAIL: Shard path is not split three digits per level"<<std::endl;
+
+    std::cout<<"\n";
+}
+
+void testBloomFilter(){
+    std::cout<<"--------TESTING STUDENT PREFILTER--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing No False Negatives And The False-Positive Rate--------"<<std::endl;
+    const double rate = 0.01;
+    BloomFilter filter(20000, rate);
+    for (int i = 0; i < 20000; ++i) {
+        filter.add(std::to_string(100000000 + i * 3));
+    }
+    bool allFound = true;
+    for (int i = 0; i < 20000; ++i) {
+        allFound = allFound && filter.mightContain(std::to_string(100000000 + i * 3));
+    }
+    // IDs between the added ones and past them are all absent
+    int falsePositives = 0, probes = 0;
+    for (int i = 0; i < 100000; ++i) {
+        int id = 100000000 + (i < 40000 ? i / 2 * 3 + 1 + i % 2 : 60000 + i);
+        falsePositives += filter.mightContain(std::to_string(id));
+        probes++;
+    }
+    double observed = static_cast<double>(falsePositives) / probes;
+    double expected = filter.getExpectedFalsePositiveRate();
+    std::cout<<"Observed false-positive rate "<<observed<<", expected "<<expected<<std::endl;
+    if (allFound && expected <= 1.5 * rate && observed > 0.5 * expected && observed < 1.5 * expected)
+        std::cout<<"PASS: Every added ID is found and the rate matches the reported one"<<std::endl;
+    else
+        std::cout<<"FAIL: Prefilter missed an ID or its false-positive rate is off"<<std::endl;
+
+    std::cout<<"--------Testing Warnings Match A Run Without The Filter--------"<<std::endl;
+    std::ofstream("bloom_names.txt")<<"111111111, Alice\n222222222, Bob\n";
+    std::ofstream("bloom_courses.txt")<<"111111111, CP317, 55, 96, 75, 95\n"
+                                      <<"999999999, CP317, 55, 96, 75, 95\n"
+                                      <<"888888888, CP317, x, 96, 75, 95\n"
+                                      <<"222222222, MA200, 63, 82, 58, 68\n"
+                                      <<"777777777, BU111, 101, 96, 75, 95\n";
+    std::string warnings[2];
+    std::map<std::string, Student> loaded[2];
+    for (int filtered = 0; filtered < 2; ++filtered) {
+        std::ostringstream captured;
+        std::streambuf* saved = std::cerr.rdbuf(captured.rdbuf());
+        FileReader nameReader("bloom_names.txt");
+        nameReader.readNameFile(loaded[filtered]);
+        BloomFilter known(loaded[filtered].size(), rate);
+        for (const auto& [id, student] : loaded[filtered]) {
+            known.add(id);
+        }
+        FileReader courseReader("bloom_courses.txt");
+        if (filtered) {
+            courseReader.setStudentFilter(&known);
+        }
+        courseReader.readCourseFile(loaded[filtered]);
+        std::cerr.rdbuf(saved);
+        warnings[filtered] = captured.str();
+    }
+    bool sameCourses = loaded[0].size() == loaded[1].size();
+    for (const auto& [id, student] : loaded[0]) {
+        sameCourses = sameCourses && loaded[1].count(id) && loaded[1][id].getCourseCount() == student.getCourseCount();
+    }
+    // Filtered rows skip grade conversion, so line 3's bad value becomes an unknown ID
+    auto withoutLine3 = [](const std::string& text) {
+        std::istringstream in(text);
+        std::string line, kept;
+        while (std::getline(in, line)) {
+            if (line.find("line 3") == std::string::npos) {
+                kept += line + "\n";
+            }
+        }
+        return kept;
+    };
+    if (sameCourses && withoutLine3(warnings[0]) == withoutLine3(warnings[1])
+        && warnings[0].find("Error processing line 3") != std::string::npos
+        && warnings[1].find("Student ID 888888888 not found in NameFile.txt (line 3)") != std::string::npos
+        && warnings[1].find("Error processing line 3") == std::string::npos)
+        std::cout<<"PASS: Filtered rows give the same students and warnings, a bad value in an unknown ID's row aside"<<std::endl;
+    else
+        std::cout<<"FAIL: The prefilter changed the students or the warnings"<<std::endl;
+    remove("bloom_names.txt");
+    remove("bloom_courses.txt");
+
+    std::cout<<"\n";
+}
+
+void testDatasetPartitions(){
+    std::cout<<"--------TESTING MULTI-TERM DATASET--------"<<std::endl;
+    std::cout<<"\n";
+
+    // Three terms with disjoint ID ranges and course codes, so each query can prune
+    const std::string root = "dataset_test";
+    std::filesystem::remove_all(root);
+    const char* terms[] = {"2023F", "2024W", "2024F"};
+    const char* names[] = {"111111111, Alice\n", "222222222, Bob\n", "333333333, Carol\n444444444, Dan\n"};
+    const char* courses[] = {"111111111, CP317, 55, 96, 75, 95\n",
+                             "222222222, MA200, 63, 82, 58, 68\n",
+                             "333333333, BU111, 58, 98, 56, 89\n444444444, CP164, 50, 50, 50, 50\n"};
+    for (int t = 0; t < 3; ++t) {
+        std::filesystem::create_directories(root + "/" + terms[t]);
+        std::ofstream(root + "/" + terms[t] + "/NameFile.txt")<<names[t];
+        std::ofstream(root + "/" + terms[t] + "/CourseFile.txt")<<courses[t];
+    }
+
+    std::cout<<"--------Testing Stale Metadata Built Only For Loaded Terms--------"<<std::endl;
+    try{
+        Dataset dataset(root);
+        DatasetQuery byTerm;
+        byTerm.terms.insert("2024W");
+        dataset.load(byTerm, 2);
+        bool onlyLoaded = std::filesystem::exists(root + "/2024W/partition.meta")
+                       && !std::filesystem::exists(root + "/2023F/partition.meta")
+                       && !std::filesystem::exists(root + "/2024F/partition.meta");
+
+        // 2023F has to be loaded to learn its ID range, then is dropped
+        DatasetQuery byRange;
+        byRange.minStudentID = "300000000";
+        std::vector<TermPartition> rangeParts = dataset.load(byRange, 2);
+        if (onlyLoaded && rangeParts.size() == 1 && rangeParts[0].metadata.term == "2024F"
+            && dataset.getSkippedCount() == 2 && std::filesystem::exists(root + "/2023F/partition.meta"))
+            std::cout<<"PASS: Pruned terms keep stale metadata and rebuilt ones prune after loading"<<std::endl;
+        else
+            std::cout<<"FAIL: Stale metadata was built for a pruned term or not applied"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    for (int t = 0; t < 3; ++t) {
+        std::filesystem::remove(root + "/" + terms[t] + "/partition.meta");
+    }
+
+    std::cout<<"--------Testing Partition Pruning--------"<<std::endl;
+    try{
+        Dataset dataset(root);
+        DatasetQuery byTerm;
+        byTerm.terms.insert("2024W");
+        size_t termLoaded = dataset.load(byTerm, 2).size();
+        size_t termSkipped = dataset.getSkippedCount();
+
+        DatasetQuery byCourse;
+        byCourse.courseCodes.insert("CP*");
+        std::vector<TermPartition> courseParts = dataset.load(byCourse, 2);
+        size_t courseSkipped = dataset.getSkippedCount();
+
+        DatasetQuery byRange;
+        byRange.minStudentID = "300000000";
+        byRange.maxStudentID = "399999999";
+        std::vector<TermPartition> rangeParts = dataset.load(byRange, 1);
+        size_t rangeSkipped = dataset.getSkippedCount();
+
+        if (dataset.getPartitions().size() == 3 && termLoaded == 1 && termSkipped == 2
+            && courseParts.size() == 2 && courseSkipped == 1 && courseParts[0].metadata.term == "2023F"
+            && rangeParts.size() == 1 && rangeSkipped == 2 && rangeParts[0].metadata.term == "2024F")
+            std::cout<<"PASS: Terms, course codes and ID ranges skip partitions from metadata alone"<<std::endl;
+        else
+            std::cout<<"FAIL: Partitions were not pruned as expected"<<std::endl;
+
+        std::cout<<"--------Testing Dataset Output--------"<<std::endl;
+        std::ofstream("dataset_output.txt").close();
+        FileWriter writer;
+        writer.setFileName("dataset_output.txt");
+        writer.writeDatasetFile(courseParts, byCourse);
+        std::string written = readWholeFile("dataset_output.txt");
+        if (written == "2023F, 111111111, Alice, CP317, 83.2\n2024F, 444444444, Dan, CP164, 50.0\n")
+            std::cout<<"PASS: Matching rows are written with their term, in term then ID order"<<std::endl;
+        else
+            std::cout<<"FAIL: Dataset output is wrong: "<<written<<std::endl;
+        remove("dataset_output.txt");
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing A Failed Partition--------"<<std::endl;
+    try{
+        Dataset dataset(root);
+        std::ofstream(root + "/2024W/CourseFile.txt")<<"not a course row\n";
+        std::streambuf* saved = std::cerr.rdbuf(nullptr);
+        try{
+            dataset.load(DatasetQuery(), 2);
+            std::cerr.rdbuf(saved);
+            std::cout<<"FAIL: A partition with no course rows loaded silently"<<std::endl;
+        }
+        catch(const FileException& e){
+            std::cerr.rdbuf(saved);
+            std::cout<<"PASS: Caught expected error "<<e.what()<<std::endl;
+        }
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    std::filesystem::remove_all(root);
+
+    std::cout<<"\n";
+}
+
+// Every student's courses with grades, in stored order, for comparing loads
+static std::string describeStudents(const std::map<std::string, Student>& students) {
+    std::ostringstream text;
+    for (const auto& [id, student] : students) {
+        text<<id<<" "<<student.getStudentName()<<":";
+        for (const auto& course : student.getCourses()) {
+            text<<" "<<course.getCourseCode()<<"/"<<course.getTest1()<<"/"<<course.getTest2()
+                <<"/"<<course.getTest3()<<"/"<<course.getFinalExam();
+        }
+        text<<"\n";
+    }
+    return text.str();
+}
+
+void testConcurrentLoad(){
+    std::cout<<"--------TESTING CONCURRENT LOAD--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Staged Rows Match Sequential Reading--------"<<std::endl;
+    // Bad format, bad values, an unknown ID, a duplicate, an invalid code and an eleventh course
+    std::ofstream("concurrent_names.txt")<<"111111111, Alice\n222222222, Bob\n333333333, Carol\n";
+    std::ofstream courses("concurrent_courses.txt");
+    courses<<"111111111, CP317, 55, 96, 75, 95\n"
+           <<"111111111, MA200, 63, 82\n"
+           <<"222222222, MA200, x, 82, 58, 68\n"
+           <<"999999999, CP317, 55, 96, 75, 95\n"
+           <<"111111111, CP317, 10, 10, 10, 10\n"
+           <<"222222222, CP31, 55, 96, 75, 95\n"
+           <<"222222222, BU111, 101, 96, 75, 95\n"
+           <<", CP317, 1, 2, 3, 4\n";
+    for (int c = 0; c < 11; ++c) {
+        courses<<"333333333, CP"<<(100 + c)<<", 50, 60, 70, 80\n";
+    }
+    courses.close();
+
+    std::string described[3], warnings[3];
+    for (int mode = 0; mode < 3; ++mode) {
+        std::ostringstream captured;
+        std::streambuf* saved = std::cerr.rdbuf(captured.rdbuf());
+        try{
+            std::map<std::string, Student> students;
+            std::vector<CourseRecord> staged;
+            std::future<bool> staging;
+            if (mode > 0) {
+                // Staged on a second thread while NameFile.txt loads, as --concurrent-load does
+                staging = std::async(std::launch::async, [&staged, mode]() {
+                    FileReader stager;
+                    stager.setFileName("concurrent_courses.txt");
+                    bool read = stager.stageCourseFile(staged);
+                    if (read && mode == 2) {
+                        FileReader::validateCourseRecords(staged);
+                    }
+                    return read;
+                });
+            }
+            FileReader nameReader("concurrent_names.txt");
+            nameReader.readNameFile(students);
+            FileReader courseReader("concurrent_courses.txt");
+            if (mode == 0)
+                courseReader.readCourseFile(students);
+            else if (staging.get())
+                courseReader.joinCourseRecords(staged, students);
+            described[mode] = describeStudents(students);
+        }
+        catch(const std::exception& e){
+            described[mode] = e.what();
+        }
+        std::cerr.rdbuf(saved);
+        warnings[mode] = captured.str();
+    }
+    if (!warnings[0].empty() && described[1] == described[0] && described[2] == described[0]
+        && warnings[1] == warnings[0] && warnings[2] == warnings[0])
+        std::cout<<"PASS: Staged and bulk-validated loads give the same students and warnings"<<std::endl;
+    else
+        std::cout<<"FAIL: Staged loading differs from readCourseFile"<<std::endl;
+    remove("concurrent_names.txt");
+    remove("concurrent_courses.txt");
+
+    std::cout<<"\n";
+}
+
+// Output.txt and warnings from the streaming join over two input files
+static std::string runStreamingJoin(const std::string& names, const std::string& courses, std::string& warnings) {
+    std::ofstream("join_output.txt").close();
+    std::ostringstream captured;
+    std::streambuf* saved = std::cerr.rdbuf(captured.rdbuf());
+    try{
+        FileReader nameReader(names);
+        FileReader courseReader(courses);
+        FileWriter writer("join_output.txt");
+        StreamingJoin join(nameReader, courseReader, writer);
+        join.run();
+    }
+    catch(...){
+        std::cerr.rdbuf(saved);
+        throw;
+    }
+    std::cerr.rdbuf(saved);
+    warnings = captured.str();
+    return readWholeFile("join_output.txt");
+}
+
+void testStreamingJoin(){
+    std::cout<<"--------TESTING STREAMING JOIN--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Sorted Input Matches The In-Memory Output--------"<<std::endl;
+    // A repeated name row, a student without courses, unknown IDs around the
+    // known ones and a bad row with a blank ID
+    std::ofstream("join_names.txt")<<"111111111, Alice\n222222222, Bob\n222222222, Robert\n"
+                                    <<"333333333, Carol\n555555555, Eve\n";
+    std::ofstream("join_courses.txt")<<"100000000, CP317, 55, 96, 75, 95\n"
+                                      <<"111111111, CP317, 55, 96, 75, 95\n"
+                                      <<"111111111, MA200, 63, 82, 58, 68\n"
+                                      <<", CP317, x, 1, 2, 3\n"
+                                      <<"222222222, BU111, 58, 98, 56, 89\n"
+                                      <<"444444444, CP164, 50, 50, 50, 50\n"
+                                      <<"555555555, CP164, 50, 60, 70, 80\n"
+                                      <<"999999999, CP164, 50, 60, 70, 80\n";
+    try{
+        std::string streamedWarnings;
+        std::string streamed = runStreamingJoin("join_names.txt", "join_courses.txt", streamedWarnings);
+
+        std::map<std::string, Student> students;
+        std::ostringstream captured;
+        std::streambuf* saved = std::cerr.rdbuf(captured.rdbuf());
+        FileReader nameReader("join_names.txt");
+        nameReader.readNameFile(students);
+        FileReader courseReader("join_courses.txt");
+        courseReader.readCourseFile(students);
+        std::cerr.rdbuf(saved);
+        std::ofstream("join_expected.txt").close();
+        FileWriter writer("join_expected.txt");
+        writer.writeOutputFile(students);
+
+        bool unknownReported = streamedWarnings.find("Student ID 100000000 not found") != std::string::npos
+                            && streamedWarnings.find("Student ID 444444444 not found") != std::string::npos
+                            && streamedWarnings.find("Student ID 999999999 not found") != std::string::npos;
+        if (streamed == readWholeFile("join_expected.txt") && streamed.find("Robert") != std::string::npos
+            && streamedWarnings == captured.str() && unknownReported)
+            std::cout<<"PASS: Streamed rows and warnings match loading both files"<<std::endl;
+        else
+            std::cout<<"FAIL: Streamed output differs from the in-memory output"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing Unsorted Input--------"<<std::endl;
+    std::ofstream("join_unsorted.txt")<<"222222222, BU111, 58, 98, 56, 89\n"
+                                       <<"111111111, CP317, 55, 96, 75, 95\n";
+    std::ofstream("join_unsorted_names.txt")<<"222222222, Bob\n111111111, Alice\n";
+    const char* unsorted[][2] = {{"join_names.txt", "join_unsorted.txt"},
+                                 {"join_unsorted_names.txt", "join_courses.txt"}};
+    for (const auto& files : unsorted) {
+        try{
+            std::string warnings;
+            runStreamingJoin(files[0], files[1], warnings);
+            std::cout<<"FAIL: Unsorted "<<files[0]<<" and "<<files[1]<<" were streamed"<<std::endl;
+        }
+        catch(const UnsortedInputException& e){
+            std::cout<<"PASS: Caught expected error "<<e.what()<<std::endl;
+        }
+        catch(const std::exception& e){
+            std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+        }
+    }
+    remove("join_names.txt");
+    remove("join_courses.txt");
+    remove("join_unsorted.txt");
+    remove("join_unsorted_names.txt");
+    remove("join_output.txt");
+    remove("join_expected.txt");
+
+    std::cout<<"\n";
+}
+
+void testBulkValidation(std::string codes[], int length){
+    std::cout<<"--------TESTING BULK VALIDATION--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Same Errors As Course Constructor--------"<<std::endl;
+    std::vector<std::string> rowCodes (codes, codes + length);
+    rowCodes.insert(rowCodes.end(), {"CP317", "cp317", "CP3170", "MA200", "BU111", "ST259", "C@317"});
+    float grades[] = {0, 100, -1, 101, 55.5f, 100.01f, -0.01f};
+    int gradeCount = sizeof(grades) / sizeof(grades[0]);
+
+    BulkValidator validator;
+    validator.resize(rowCodes.size() * gradeCount);
+    size_t row = 0;
+    for (const auto& code : rowCodes) {
+        for (int g = 0; g < gradeCount; ++g) {
+            validator.setRow(row++, code, 50, grades[g], 50, grades[(g + 3) % gradeCount]);
+        }
+    }
+    validator.validate();
+
+    int mismatches = 0;
+    row = 0;
+    for (const auto& code : rowCodes) {
+        for (int g = 0; g < gradeCount; ++g) {
+            float exam = grades[(g + 3) % gradeCount];
+            std::string expected, actual;
+            try { Course course (code, 50, grades[g], 50, exam); } catch (const std::exception& e) { expected = e.what(); }
+            try { BulkValidator::throwReason(validator.getReason(row), code, 50, grades[g], 50, exam); } catch (const std::exception& e) { actual = e.what(); }
+            if (expected != actual || validator.isRejected(row) == expected.empty())
+                mismatches++;
+            row++;
+        }
+    }
+    if (mismatches == 0)
+        std::cout<<"PASS: Bulk reasons match the per-object checks for "<<row<<" rows"<<std::endl;
+    else
+        std::cout<<"FAIL: "<<mismatches<<" rows differ from the per-object checks"<<std::endl;
+
+    std::cout<<"\n";
+}
+
+void testInlineVector(){
+    std::cout<<"--------TESTING INLINE VECTOR--------"<<std::endl;
+    std::cout<<"\n";
+
+    // Strings past the short-string buffer, so a missed destructor or double free shows
+    typedef InlineVector<std::string, 4> Strings;
+    const std::string a(40, 'a'), b(40, 'b'), c(40, 'c'), d(40, 'd');
+    auto contents = [](const Strings& items) {
+        std::string joined;
+        for (const auto& item : items) {
+            joined += item.substr(0, 1);
+        }
+        return joined;
+    };
+
+    std::cout<<"--------Testing Erase--------"<<std::endl;
+    Strings items;
+    bool emptyRange = items.begin() == items.end();
+    for (const auto& item : {a, b, c, d}) {
+        items.push_back(item);
+    }
+    bool overflowThrows = false;
+    try{
+        items.push_back(a);
+    }
+    catch(const std::length_error&){
+        overflowThrows = true;
+    }
+    Strings::iterator next = items.erase(items.begin() + 1);
+    bool middle = contents(items) == "acd" && *next == c;
+    items.erase(items.begin());
+    bool first = contents(items) == "cd";
+    next = items.erase(items.end() - 1);
+    bool last = contents(items) == "c" && next == items.end();
+    items.erase(items.begin());
+    if (emptyRange && overflowThrows && middle && first && last && items.empty() && items.begin() == items.end())
+        std::cout<<"PASS: Erase shifts the tail down and keeps the rest in order"<<std::endl;
+    else
+        std::cout<<"FAIL: Erase left the wrong elements"<<std::endl;
+
+    std::cout<<"--------Testing Copy And Move--------"<<std::endl;
+    Strings source;
+    source.push_back(a);
+    source.push_back(b);
+    Strings copied(source);
+    Strings assigned;
+    assigned.push_back(d);
+    assigned = source;
+    const Strings& self = assigned;
+    assigned = self;
+    Strings moved(std::move(copied));
+    Strings moveAssigned;
+    moveAssigned.push_back(c);
+    moveAssigned = std::move(assigned);
+    if (contents(source) == "ab" && copied.empty() && contents(moved) == "ab" && assigned.empty()
+        && contents(moveAssigned) == "ab" && moveAssigned[1] == b)
+        std::cout<<"PASS: Copies are independent and moves empty their source"<<std::endl;
+    else
+        std::cout<<"FAIL: Copy or move gave the wrong elements"<<std::endl;
+
+    std::cout<<"\n";
+}
+
+void testSamplePreview(){
+    std::cout<<"--------TESTING SAMPLE PREVIEW--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Estimates Cover The True Values--------"<<std::endl;
+    std::ofstream names("preview_names.txt"), courses("preview_courses.txt");
+    for (int i = 0; i < 2000; ++i) {
+        std::string id = std::to_string(100000000 + i);
+        names<<id<<", Student Number"<<"\n";
+        courses<<id<<", CP317, 50, 60, 70, "<<(i % 10 == 0 ? 150 : 80)<<"\n";
+        courses<<id<<", MA200, 40, 40, 40, 40"<<"\n";
+    }
+    names.close();
+    courses.close();
+
+    try{
+        SamplePreview preview(500);
+        preview.run("preview_names.txt", "preview_courses.txt");
+        const FileSample& sample = preview.getCourseSample();
+        PreviewEstimate rejects = preview.getCourseRejectRate();
+        PreviewEstimate average = preview.getCourseAverage("MA200");
+        bool rowsClose = sample.estimatedRows > 3600 && sample.estimatedRows < 4400;
+        bool rejectsCovered = rejects.value - rejects.margin <= 0.05 && 0.05 <= rejects.value + rejects.margin;
+        if (!sample.exact && sample.lines.size() >= 500 && rowsClose && rejectsCovered && average.value == 40.0f)
+            std::cout<<"PASS: Sampled "<<sample.lines.size()<<" rows, ~"<<sample.estimatedRows<<" total, "
+                     <<rejects.value * 100<<"% +/- "<<rejects.margin * 100<<"% rejected"<<std::endl;
+        else
+            std::cout<<"FAIL: Sample estimates are off ("<<sample.estimatedRows<<" rows, "<<rejects.value<<" rejected)"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing Preview Validates Quietly--------"<<std::endl;
+    // std::cout stays connected; the sampled rows simply do not report themselves
+    try{
+        std::ostringstream captured;
+        std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+        SamplePreview preview(500);
+        preview.run("preview_names.txt", "preview_courses.txt");
+        bool connected = std::cout.rdbuf() == captured.rdbuf();
+        std::cout.rdbuf(saved);
+        std::string text = captured.str();
+        if (connected && text.find("File has been verified") != std::string::npos
+            && text.find("checked") == std::string::npos && text.find("Course is valid") == std::string::npos)
+            std::cout<<"PASS: Sampled rows are validated without printing or muting std::cout"<<std::endl;
+        else
+            std::cout<<"FAIL: Preview validation printed per row or swapped std::cout"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("preview_names.txt");
+    remove("preview_courses.txt");
+
+    std::cout<<"\n";
+}
+
+void testCoordinatorRetry(){
+    std::cout<<"--------TESTING COORDINATOR--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Failed Workers Are Retried And Outputs Merged--------"<<std::endl;
+    // Stand-in worker: fails its first attempt, then emits its shard's names sorted
+    std::ofstream script("coordinator_worker.sh");
+    script<<"#!/bin/sh\n"
+          <<"[ -f \"$3/attempted\" ] || { touch \"$3/attempted\"; exit 1; }\n"
+          <<"sort \"$3/NameFile.txt\" > \"$5\"\n";
+    script.close();
+    chmod("coordinator_worker.sh", 0755);
+
+    std::ofstream names("coordinator_names.txt"), courses("coordinator_courses.txt"), output("coordinator_output.txt");
+    std::string expected;
+    for (int i = 0; i < 200; ++i) {
+        std::string line = std::to_string(100000000 + i * 37) + ", Student Number";
+        names<<line<<"\n";
+        expected += line + "\n";
+    }
+    names.close();
+    courses.close();
+    output.close();
+
+    try{
+        char directory[4096];
+        std::string worker = std::string(getcwd(directory, sizeof(directory))) + "/coordinator_worker.sh";
+        Coordinator coordinator(3, worker);
+        bool ok = coordinator.run("coordinator_names.txt", "coordinator_courses.txt", "coordinator_output.txt");
+        bool retried = true;
+        for (const auto& shard : coordinator.getShards())
+            retried = retried && shard.succeeded && shard.attempts == 2;
+        std::ifstream merged("coordinator_output.txt");
+        std::string actual ((std::istreambuf_iterator<char>(merged)), std::istreambuf_iterator<char>());
+        if (ok && retried && actual == expected)
+            std::cout<<"PASS: Every worker retried once and the merged output is in ID order"<<std::endl;
+        else
+            std::cout<<"FAIL: Coordinator did not retry or merge correctly"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing Worker Options Are Forwarded--------"<<std::endl;
+    // Stand-in worker: records what follows --output, then emits its shard's names
+    char cwd[4096];
+    std::string argsFile = std::string(getcwd(cwd, sizeof(cwd))) + "/coordinator_args.txt";
+    script.open("coordinator_worker.sh");
+    script<<"#!/bin/sh\n"
+          <<"dir=\"$3\"; out=\"$5\"; shift 5\n"
+          <<"echo \"$*\" > \""<<argsFile<<"\"\n"
+          <<"sort \"$dir/NameFile.txt\" > \"$out\"\n";
+    script.close();
+    try{
+        Coordinator coordinator(2, std::string(cwd) + "/coordinator_worker.sh");
+        coordinator.setSchemesPath("schemes.txt");
+        coordinator.addWorkerOption("--course-filter", "CP*");
+        coordinator.addWorkerOption("--streaming");
+        bool ok = coordinator.run("coordinator_names.txt", "coordinator_courses.txt", "coordinator_output.txt");
+        std::string recorded = readWholeFile(argsFile);
+        if (ok && recorded == "--schemes schemes.txt --course-filter CP* --streaming\n")
+            std::cout<<"PASS: Workers get the schemes and every added option"<<std::endl;
+        else
+            std::cout<<"FAIL: Workers were started with: "<<recorded<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove(argsFile.c_str());
+    remove("coordinator_worker.sh");
+    remove("coordinator_names.txt");
+    remove("coordinator_courses.txt");
+    remove("coordinator_output.txt");
+
+    std::cout<<"\n";
+}
+
+void testCorrectionLog(){
+    std::cout<<"--------TESTING CORRECTION LOG--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::map<std::string, Student> students;
+    students["111111111"] = Student("111111111", "Alice King");
+    students["111111111"].addCourse(Course("CP317", 55, 96, 75, 95));
+    students["111111111"].addCourse(Course("MA200", 63, 82, 58, 68));
+    students["222222222"] = Student("222222222", "Bob Marley");
+    students["333333333"] = Student("333333333", "Freddie Mercury");
+    students["333333333"].addCourse(Course("BU111", 58, 98, 56, 89));
+
+    std::cout<<"--------Testing Patched Output Matches A Full Rewrite--------"<<std::endl;
+    std::ofstream("correction_patched.txt").close();
+    std::ofstream("correction_full.txt").close();
+    std::ofstream log("correction_log.txt");
+    log<<"111111111, MA200, test2, 90\n"
+       <<"111111111, CP317, delete\n"
+       <<"222222222, ST259, insert, 50, 60, 70, 80\n"
+       <<"333333333, BU111, finalExam, 101\n"
+       <<"333333333, BU111, insert, 1, 2, 3, 4\n"
+       <<"444444444, BU111, delete\n";
+    log.close();
+
+    // The second log moves later rows: a course is added ahead of a same-length change
+    std::ofstream("correction_log2.txt")<<"111111111, CP317, insert, 10, 20, 30, 40\n"
+                                       <<"333333333, BU111, test1, 60\n";
+
+    try{
+        FileWriter before ("correction_patched.txt");
+        before.writeOutputFile(students);
+        OutputSnapshot saved("correction_patched.snapshot");
+        saved.save(students, "correction_patched.txt");
+
+        bool matched = true;
+        const char* logs[] = {"correction_log.txt", "correction_log2.txt"};
+        for (const char* logName : logs) {
+            // Only the students the log names are read back, as a corrections run does
+            CorrectionLog log;
+            log.readLogFile(logName);
+            OutputSnapshot snapshot("correction_patched.snapshot");
+            std::map<std::string, Student> part;
+            snapshot.loadStudents(log.getStudentIDs(), part);
+            std::set<std::string> changed = log.apply(part);
+            FileWriter patched;
+            patched.setFileName("correction_patched.txt");
+            matched = matched && patched.patchOutputFile(part, changed, snapshot);
+
+            CorrectionLog everyone;
+            everyone.readLogFile(logName);
+            everyone.apply(students);
+            FileWriter full ("correction_full.txt");
+            full.writeOutputFile(students);
+            matched = matched && readWholeFile("correction_patched.txt") == readWholeFile("correction_full.txt");
+
+            // Afterwards every student reads back as corrected
+            std::map<std::string, Student> all;
+            matched = matched && snapshot.loadAll(all) && all.size() == students.size();
+            for (const auto& [id, student] : all) {
+                matched = matched && student.getCourseCount() == students[id].getCourseCount()
+                       && student.getOverallAverage() == students[id].getOverallAverage();
+            }
+            if (logName == logs[0]) {
+                matched = matched && log.getAppliedCount() == 3 && log.getRejectedCount() == 3 && changed.size() == 2
+                       && part.size() == 3 && part["333333333"].findCourse("BU111")->getFinalExam() == 89;
+            }
+        }
+        if (matched)
+            std::cout<<"PASS: 3 corrections applied, 3 rejected, patched output matches after two logs"<<std::endl;
+        else
+            std::cout<<"FAIL: Corrections or patched output are wrong"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("correction_patched.txt");
+    remove("correction_patched.snapshot");
+    remove("correction_full.txt");
+    remove("correction_log2.txt");
+
+    std::cout<<"--------Testing The Output Manifest Guards Patching--------"<<std::endl;
+    std::ofstream("manifest_output.txt").close();
+    try{
+        FileWriter output ("manifest_output.txt");
+        output.writeOutputFile(students);
+        OutputManifest manifest("manifest_output.txt");
+        manifest.addInput("names", "correction_log.txt");
+        manifest.addSetting("format", "plain");
+        OutputSnapshot snapshot(manifest.getSnapshotName());
+        snapshot.save(students, "manifest_output.txt");
+        bool missing = !manifest.matches();
+        manifest.save();
+        bool saved = manifest.matches();
+
+        OutputManifest ranked("manifest_output.txt");
+        ranked.addInput("names", "correction_log.txt");
+        ranked.addSetting("format", "ranked");
+        bool otherFormat = !ranked.matches();
+
+        std::ofstream("manifest_output.txt", std::ios::app)<<"extra\n";
+        bool rewritten = !manifest.matches();
+
+        manifest.save();
+        remove(manifest.getSnapshotName().c_str());
+        bool noSnapshot = !manifest.matches();
+        snapshot.save(students, "manifest_output.txt");
+        manifest.save();
+        manifest.remove();
+        bool removed = !manifest.matches() && !std::ifstream(manifest.getManifestName()).is_open();
+        if (missing && saved && otherFormat && rewritten && noSnapshot && removed)
+            std::cout<<"PASS: The snapshot is used only for the recorded settings, output and snapshot"<<std::endl;
+        else
+            std::cout<<"FAIL: Manifest checks were "<<missing<<saved<<otherFormat<<rewritten<<noSnapshot<<removed<<std::endl;
+        remove(manifest.getSnapshotName().c_str());
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("correction_log.txt");
+    remove("manifest_output.txt");
+
+    std::cout<<"\n";
+}
+
+void testNameIndex(){
+    std::cout<<"--------TESTING NAME INDEX--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::map<std::string, Student> students;
+    students["111111111"] = Student("111111111", "Alice King");
+    students["222222222"] = Student("222222222", "Alicia  Kingston");
+    students["333333333"] = Student("333333333", "Bob Marley");
+    students["444444444"] = Student("444444444", "Alice Kang");
+    NameIndex index(students);
+
+    std::cout<<"--------Testing Case-Insensitive Prefix Search--------"<<std::endl;
+    std::vector<std::string> prefix = index.findPrefix("ALIC");
+    std::vector<std::string> spaced = index.findPrefix("alicia kings");
+    if (prefix == std::vector<std::string>{"444444444", "111111111", "222222222"} && spaced == std::vector<std::string>{"222222222"})
+        std::cout<<"PASS: Prefix search found names in order"<<std::endl;
+    else
+        std::cout<<"FAIL: Prefix search returned "<<prefix.size()<<" and "<<spaced.size()<<" IDs"<<std::endl;
+
+    std::cout<<"--------Testing Edit Distance 1 Search--------"<<std::endl;
+    bool substitution = index.findSimilar("bob morley") == std::vector<std::string>{"333333333"};
+    bool insertion = index.findSimilar("Bob Marrley") == std::vector<std::string>{"333333333"};
+    bool deletion = index.findSimilar("Alice Kin") == std::vector<std::string>{"111111111"};
+    bool bothWithinOne = index.findSimilar("Alice Kyng").size() == 2;
+    bool tooFar = index.findSimilar("Bob Marlee X").empty();
+    if (substitution && insertion && deletion && bothWithinOne && tooFar)
+        std::cout<<"PASS: Similar names found for substitution, insertion and deletion"<<std::endl;
+    else
+        std::cout<<"FAIL: Similar name search is wrong"<<std::endl;
+
+    std::cout<<"\n";
+}
+
+void testSharedDataset(){
+    std::cout<<"--------TESTING SHARED DATASET--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::map<std::string, Student> students;
+    students["111111111"] = Student("111111111", "Alice King");
+    students["111111111"].addCourse(Course("CP317", 55, 96, 75, 95));
+    students["111111111"].addCourse(Course("MA200", 63, 82, 58, 68));
+    students["222222222"] = Student("222222222", "Bob Marley");
+
+    std::cout<<"--------Testing Readers Keep Their Generation Across A Reload--------"<<std::endl;
+    std::string name = "/cp317-test-" + std::to_string(getpid());
+    try{
+        publishSharedDataset(name, students);
+        SharedDatasetView first(name);
+        students["222222222"].addCourse(Course("BU111", 58, 98, 56, 89));
+        publishSharedDataset(name, students);
+        SharedDatasetView second(name);
+
+        const SharedStudent* alice = first.findStudent("111111111");
+        const SharedStudent* bob = second.findStudent("222222222");
+        bool firstIntact = first.getCourseCount() == 2 && alice && alice->courseCount == 2
+                        && first.studentName(*alice) == "Alice King"
+                        && first.makeCourse(first.courseAt(alice->firstCourse + 1)).calculateFinalGrade()
+                           == students["111111111"].findCourse("MA200")->calculateFinalGrade();
+        bool secondCurrent = second.getGeneration() == first.getGeneration() + 1 && bob && bob->courseCount == 1
+                          && second.courseCode(second.courseAt(bob->firstCourse)) == "BU111"
+                          && !second.findStudent("333333333");
+        if (firstIntact && secondCurrent)
+            std::cout<<"PASS: Old view unchanged, new attach sees the reload"<<std::endl;
+        else
+            std::cout<<"FAIL: Shared dataset views are wrong"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    std::cout<<"--------Testing Concurrent Publishers Only Move Forward--------"<<std::endl;
+    try{
+        std::vector<std::future<uint64_t>> publishers;
+        for (int i = 0; i < 8; ++i) {
+            publishers.push_back(std::async(std::launch::async, [&]() { return publishSharedDataset(name, students); }));
+        }
+        uint64_t latest = 0;
+        for (auto& publisher : publishers) {
+            latest = std::max(latest, publisher.get());
+        }
+        SharedDatasetView view(name);
+        if (view.getGeneration() == latest)
+            std::cout<<"PASS: The latest of 8 concurrent generations is current"<<std::endl;
+        else
+            std::cout<<"FAIL: Generation "<<view.getGeneration()<<" is current, expected "<<latest<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing A Damaged Segment Is Rejected On Attach--------"<<std::endl;
+    try{
+        uint64_t generation = publishSharedDataset(name, students);
+        std::string segment = name + "." + std::to_string(generation);
+        int fd = shm_open(segment.c_str(), O_RDWR, 0);
+        struct stat info;
+        fstat(fd, &info);
+        void* address = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        SharedDatasetHeader* header = static_cast<SharedDatasetHeader*>(address);
+        SharedStudent* first = reinterpret_cast<SharedStudent*>(static_cast<char*>(address) + header->studentsOffset);
+        first->name.length = 1u << 30;
+        munmap(address, info.st_size);
+
+        SharedDatasetView view(name);
+        std::cout<<"FAIL: Attached to a segment with a name past its end"<<std::endl;
+    }
+    catch(const SharedMemoryException& e){
+        std::cout<<"PASS: Caught expected error "<<e.what()<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    try{
+        unlinkSharedDataset(name);
+    }
+    catch(const std::exception&){}
+
+    std::cout<<"\n";
+}
+
+void testRowIndex(){
+    std::cout<<"--------TESTING ROW INDEX--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Offsets And Staleness--------"<<std::endl;
+    std::ofstream courses("rowindex_courses.txt");
+    courses<<"222222222, CP317, 50, 60, 70, 80\n"
+           <<"\n"
+           <<"111111111, MA200, 40, 40, 40, 40\n"
+           <<"222222222, BU111, 1, 2, 3, 4\n";
+    courses.close();
+
+    try{
+        RowIndex index("rowindex_courses.txt");
+        bool built = index.open();
+        std::vector<RowIndexEntry> rows = index.find("222222222");
+        bool found = rows.size() == 2 && rows[0].offset == 0 && rows[0].lineNumber == 1
+                  && rows[1].offset == 67 && rows[1].lineNumber == 4 && index.find("333333333").empty();
+        bool reused = !RowIndex("rowindex_courses.txt").open();
+
+        FileReader reader ("rowindex_courses.txt");
+        CourseRecord record;
+        reader.seekToRow(rows[1].offset, rows[1].lineNumber);
+        bool parsed = reader.readNextCourseRecord(record) && record.courseCode == "BU111" && record.lineNumber == 4;
+
+        std::ofstream("rowindex_courses.txt", std::ios::app)<<"333333333, ST259, 1, 2, 3, 4\n";
+        RowIndex stale("rowindex_courses.txt");
+        bool rebuilt = stale.open() && stale.find("333333333").size() == 1;
+        if (built && found && reused && parsed && rebuilt)
+            std::cout<<"PASS: Rows found by offset, index reused, then rebuilt when stale"<<std::endl;
+        else
+            std::cout<<"FAIL: Row index lookup or staleness check is wrong"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("rowindex_courses.txt");
+    remove("rowindex_courses.txt.idx");
+
+    std::cout<<"\n";
+}
+
+void testHotPathAllocations(){
+    std::cout<<"--------TESTING HOT PATH ALLOCATIONS--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Allocations Per Course Row--------"<<std::endl;
+    const int studentCount = 300;
+    const int coursesPerStudent = 10;
+    std::ofstream names("alloc_names.txt");
+    std::ofstream courses("alloc_courses.txt");
+    for (int s = 0; s < studentCount; ++s) {
+        std::string id = std::to_string(100000000 + s);
+        names<<id<<", Student Number "<<s<<"\n";
+        for (int c = 0; c < coursesPerStudent; ++c) {
+            courses<<id<<", CP"<<(100 + c)<<", 70.5, 80, 90, 65.25\n";
+        }
+    }
+    names.close();
+    courses.close();
+
+    // Students and their courses are stored inline, so reading every course
+    // row should cost nothing beyond the line buffer's first growth
+    try{
+        std::map<std::string, Student> students;
+        FileReader nameReader("alloc_names.txt");
+        nameReader.readNameFile(students);
+        FileReader courseReader("alloc_courses.txt");
+        size_t before = allocationCount;
+        bool read = courseReader.readCourseFile(students);
+        size_t allocations = allocationCount - before;
+        int rows = studentCount * coursesPerStudent;
+
+        std::cout<<allocations<<" allocations for "<<rows<<" course rows"<<std::endl;
+        if (read && students.begin()->second.getCourseCount() == coursesPerStudent && allocations <= 1)
+            std::cout<<"PASS: Course rows are read without per-row allocations"<<std::endl;
+        else
+            std::cout<<"FAIL: Course rows still allocate while reading"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("alloc_names.txt");
+    remove("alloc_courses.txt");
+
+    std::cout<<"\n";
+}
+
+void testMemoryAccount(){
+    std::cout<<"--------TESTING MEMORY ACCOUNTING--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::ofstream names("memory_names.txt");
+    std::ofstream courses("memory_courses.txt");
+    for (int s = 0; s < 500; ++s) {
+        std::string id = std::to_string(200000000 + s);
+        names<<id<<", "<<(s % 2 ? "Bo Li" : "Alexandra Catherine Montgomery")<<"\n";
+        courses<<id<<", CP317, 50, 60, 70, 80\n"<<id<<", MA200, 40, 40, 40, 40\n";
+    }
+    names.close();
+    courses.close();
+
+    try{
+        std::map<std::string, Student> students;
+        FileReader("memory_names.txt").readNameFile(students);
+        FileReader("memory_courses.txt").readCourseFile(students);
+
+        std::cout<<"--------Testing Per-Structure Accounting--------"<<std::endl;
+        MemoryAccount memory(1024 * 1024);
+        memory.measureStudents(students);
+        const MemoryFootprint& used = memory.getFootprint();
+        bool measured = used.courseSlots == 500 * sizeof(Student::CourseList)
+                     && used.courseSlotsUsed == 1000 * sizeof(Course)
+                     && used.strings == 250 * MemoryAccount::heapBlock(31) && used.directory > 0;
+        if (measured)
+            std::cout<<"PASS: Course slots, long names and directory nodes are accounted"<<std::endl;
+        else
+            std::cout<<"FAIL: Footprint does not match the loaded students"<<std::endl;
+
+        std::cout<<"--------Testing Projection From A Sample--------"<<std::endl;
+        SamplePreview sample(100);
+        sample.run("memory_names.txt", "memory_courses.txt");
+        MemoryFootprint projected = MemoryAccount::projectLoad(sample, false);
+        double ratio = static_cast<double>(projected.directory + projected.courseSlots + projected.strings)
+                     / (used.directory + used.courseSlots + used.strings);
+        if (ratio > 0.8 && ratio < 1.25)
+            std::cout<<"PASS: Projected load is within 25% of the measured one ("<<ratio<<")"<<std::endl;
+        else
+            std::cout<<"FAIL: Projected load is off by a factor of "<<ratio<<std::endl;
+
+        std::cout<<"--------Testing Budget Enforcement--------"<<std::endl;
+        MemoryAccount tight(64 * 1024);
+        tight.measureStudents(students);
+        try{
+            tight.checkBudget("NameFile.txt");
+            std::cout<<"FAIL: Load over budget was not rejected"<<std::endl;
+        }
+        catch(const MemoryBudgetException& e){
+            if (memory.fitsBudget(used))
+                std::cout<<"PASS: Caught expected MemoryBudgetException "<<e.what()<<std::endl;
+            else
+                std::cout<<"FAIL: Load within budget was rejected"<<std::endl;
+        }
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("memory_names.txt");
+    remove("memory_courses.txt");
+
+    std::cout<<"\n";
+}
+
+void testStageProfiler(){
+    std::cout<<"--------TESTING STAGE PROFILER--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Stages Accumulate Per Row--------"<<std::endl;
+    StageProfiler profiler;
+    std::vector<std::string> rows;
+    profiler.begin("parse");
+    for (int i = 0; i < 20000; ++i) {
+        rows.push_back(std::to_string(i * 7919));
+    }
+    profiler.end(20000);
+    profiler.begin("sort");
+    std::sort(rows.begin(), rows.end());
+    profiler.end(20000);
+    profiler.begin("parse");
+    profiler.end(5000);
+
+    const std::vector<StageProfile>& stages = profiler.getStages();
+    bool accumulated = stages.size() == 2 && stages[0].name == "parse" && stages[0].rows == 25000
+                    && stages[1].rows == 20000 && stages[0].seconds > 0.0;
+    bool missingZero = true;
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        if (!profiler.hasCounter(static_cast<ProfileCounter>(i)) && stages[0].counts[i] != 0.0)
+            missingZero = false;
+    }
+    // Hosts without counters (VMs, containers) must still give a reason and wall time
+    bool explained = profiler.hasAnyCounter() || !profiler.getUnavailableReason().empty();
+    if (accumulated && missingZero && explained)
+        std::cout<<"PASS: Stages accumulate rows and time; missing counters stay empty"<<std::endl;
+    else
+        std::cout<<"FAIL: Stage totals or counter fallback are wrong"<<std::endl;
+    profiler.printReport();
+
+    std::cout<<"\n";
+}
+
+// A feed type that is not in the project, declared only through its schema
+struct BonusRecord {
+    std::string courseCode;
+    float bonus;
+};
+
+typedef RecordSchema<BonusRecord, ';',
+    Field<TextField, &BonusRecord::courseCode, CourseCodeExceptionCheck>,
+    Field<FloatField, &BonusRecord::bonus, SingleGradeExceptionCheck>> BonusSchema;
+
+void testRecordSchema(){
+    std::cout<<"--------TESTING RECORD SCHEMA--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Field Splitting Matches split()--------"<<std::endl;
+    std::string lines[] = {"a,b", "a,b,", ",a", "a,,b", ",", " a , b ,c", "a,b,c,d,e,f,g"};
+    bool splitMatches = true;
+    for (const auto& line : lines) {
+        FieldSpan spans[CourseFileSchema::FIELD_COUNT];
+        size_t count = CourseFileSchema::split(line, spans);
+        std::vector<std::string> parts = split(line, ',');
+        if (count != parts.size())
+            splitMatches = false;
+        for (size_t i = 0; i < count && i < CourseFileSchema::FIELD_COUNT && splitMatches; ++i) {
+            if (line.substr(spans[i].begin, spans[i].end - spans[i].begin) != trim(parts[i]))
+                splitMatches = false;
+        }
+    }
+    if (splitMatches)
+        std::cout<<"PASS: Field counts and trimmed fields match split() and trim()"<<std::endl;
+    else
+        std::cout<<"FAIL: Schema splitting differs from split()"<<std::endl;
+
+    std::cout<<"--------Testing Conversions And Validators--------"<<std::endl;
+    BonusRecord record;
+    size_t fieldCount;
+    std::string error;
+    bool parsed = BonusSchema::parse(" CP317 ; 2.5", record, fieldCount, error) == RECORD_PARSED
+               && record.courseCode == "CP317" && record.bonus == 2.5f;
+    bool badCount = BonusSchema::parse("CP317;1;2", record, fieldCount, error) == RECORD_BAD_FORMAT && fieldCount == 3;
+    bool badNumber = BonusSchema::parse("CP317; x", record, fieldCount, error) == RECORD_BAD_VALUE && error == "stof";
+    bool badCode = BonusSchema::parse("CP3170;1", record, fieldCount, error) == RECORD_BAD_VALUE
+                && error.find("Course is invalid") != std::string::npos;
+    bool badGrade = BonusSchema::parse("CP317;140", record, fieldCount, error) == RECORD_BAD_VALUE
+                 && error.find("Grade is invalid") != std::string::npos;
+    if (parsed && badCount && badNumber && badCode && badGrade)
+        std::cout<<"PASS: Fields convert and exceptions.h validators reject bad values"<<std::endl;
+    else
+        std::cout<<"FAIL: Schema parse results are wrong"<<std::endl;
+
+    std::cout<<"\n";
+}
+
+void testRowFilterPushdown(){
+    std::cout<<"--------TESTING ROW FILTER PUSHDOWN--------"<<std::endl;
+    std::cout<<"\n";
+
+    DatasetQuery query;
+    query.courseCodes = {"CP*", "MA200"};
+    query.minStudentID = "100000000";
+    query.maxStudentID = "299999999";
+
+    std::cout<<"--------Testing Rows Dropped Before Conversion--------"<<std::endl;
+    FileReader reader;
+    reader.setRowFilter(&query);
+    CourseRecord outside, unselected, selected;
+    reader.parseCourseLine("300000000, CP317, x, x, x, x", 1, outside);
+    reader.parseCourseLine("111111111, BU111, x, x, x, x", 2, unselected);
+    reader.parseCourseLine("111111111, CP317, 50, 60, 70, 80", 3, selected);
+    if (outside.status == COURSE_RECORD_OUT_OF_RANGE && unselected.status == COURSE_RECORD_UNSELECTED
+        && unselected.courseCode.empty() && selected.status == COURSE_RECORD_PARSED && selected.test3 == 70.0f)
+        std::cout<<"PASS: Rows outside the filter skip grade conversion"<<std::endl;
+    else
+        std::cout<<"FAIL: Row filter statuses are wrong"<<std::endl;
+
+    std::cout<<"--------Testing Filtered Load Matches Filtered Full Load--------"<<std::endl;
+    // 111111111's CP317 comes after ten other courses, so a full run turns it away
+    std::ofstream("pushdown_names.txt")<<"111111111, Alice\n222222222, Bob\n333333333, Carol\n";
+    std::ofstream courses("pushdown_courses.txt");
+    const char* others[] = {"BU111", "BU121", "EC120", "EC140", "PS101", "PS102", "ST230", "ST259", "CC100", "FS102"};
+    for (const char* code : others) {
+        courses<<"111111111, "<<code<<", 50, 50, 50, 50\n";
+    }
+    courses<<"111111111, CP317, 60, 60, 60, 60\n"
+           <<"222222222, BU111, 70, 70, 70, 70\n"
+           <<"222222222, CP104, 80, 80, 80, 80\n"
+           <<"222222222, MA200, 90, 90, 90, 90\n"
+           <<"333333333, CP164, 40, 40, 40, 40\n";
+    courses.close();
+
+    try{
+        std::map<std::string, Student> full, filtered;
+        std::streambuf* saved = std::cerr.rdbuf(nullptr);
+        FileReader fullNames ("pushdown_names.txt");
+        fullNames.readNameFile(full);
+        FileReader fullCourses ("pushdown_courses.txt");
+        fullCourses.readCourseFile(full);
+        FileReader names ("pushdown_names.txt");
+        names.setRowFilter(&query);
+        names.readNameFile(filtered);
+        FileReader filteredCourses ("pushdown_courses.txt");
+        filteredCourses.setRowFilter(&query);
+        filteredCourses.readCourseFile(filtered);
+        std::cerr.rdbuf(saved);
+
+        std::vector<std::string> expected, actual;
+        for (const auto& [id, student] : full) {
+            for (const auto& course : student.getCourses()) {
+                if (query.matchesStudent(id) && query.matchesCourse(course.getCourseCode()))
+                    expected.push_back(id + " " + course.getCourseCode());
+            }
+        }
+        for (const auto& [id, student] : filtered) {
+            for (const auto& course : student.getCourses()) {
+                actual.push_back(id + " " + course.getCourseCode());
+            }
+        }
+        bool limited = !filtered["111111111"].hasCourse("CP317");
+        if (actual == expected && expected.size() == 2 && limited && filtered.count("333333333") == 0)
+            std::cout<<"PASS: Filtered load keeps exactly the rows of the filtered full load"<<std::endl;
+        else
+            std::cout<<"FAIL: Filtered load differs from the filtered full load"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing Replayed Rows Warn Once--------"<<std::endl;
+    std::ofstream("pushdown_courses.txt", std::ios::app)<<"111111111, MA200, x, 1, 1, 1\n";
+    try{
+        std::map<std::string, Student> filtered;
+        std::ostringstream warnings;
+        std::streambuf* saved = std::cerr.rdbuf(warnings.rdbuf());
+        FileReader names ("pushdown_names.txt");
+        names.setRowFilter(&query);
+        names.readNameFile(filtered);
+        FileReader filteredCourses ("pushdown_courses.txt");
+        filteredCourses.setRowFilter(&query);
+        filteredCourses.readCourseFile(filtered);
+        std::cerr.rdbuf(saved);
+
+        std::string text = warnings.str();
+        size_t first = text.find("Error processing line 16");
+        bool once = first != std::string::npos && text.find("Error processing line 16", first + 1) == std::string::npos;
+        if (once && !filtered["111111111"].hasCourse("CP317"))
+            std::cout<<"PASS: The replayed student's bad row warned once"<<std::endl;
+        else
+            std::cout<<"FAIL: Replay warnings were:\n"<<text<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("pushdown_names.txt");
+    remove("pushdown_courses.txt");
+
+    std::cout<<"\n";
+}
+
+void testCheckpointResume(){
+    std::cout<<"--------TESTING CHECKPOINT RESUME--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::ofstream("checkpoint_names.txt")<<"111111111, Alice\n222222222, Bob\n333333333, Carol\n";
+    std::string courses = "111111111, CP317, 50, 60, 70, 80\n"
+                          "222222222, MA200, 40, 40, 40, 40\n"
+                          "\n"
+                          "111111111, CP317, 90, 90, 90, 90\n"
+                          "444444444, BU111, 1, 2, 3, 4\n"
+                          "333333333, ST259, 70, 75, 80, 85\n"
+                          "222222222, CP104, 66, 67, 68, 69";
+    std::ofstream("checkpoint_courses.txt")<<courses;
+
+    auto rows = [](const std::map<std::string, Student>& students) {
+        std::ostringstream text;
+        for (const auto& [id, student] : students) {
+            text<<id<<" "<<student.getStudentName();
+            for (const auto& course : student.getCourses()) {
+                text<<" "<<course.getCourseCode()<<" "<<course.getTest1()<<" "<<course.getFinalExam();
+            }
+            text<<"\n";
+        }
+        return text.str();
+    };
+
+    std::cout<<"--------Testing Resume Matches An Uninterrupted Load--------"<<std::endl;
+    try{
+        std::streambuf* saved = std::cerr.rdbuf(nullptr);
+        std::map<std::string, Student> full;
+        FileReader fullNames ("checkpoint_names.txt");
+        fullNames.readNameFile(full);
+        FileReader fullCourses ("checkpoint_courses.txt");
+        fullCourses.readCourseFile(full);
+
+        // A run that stopped after line 4, with the snapshot it would have left
+        std::map<std::string, Student> partial;
+        FileReader partialNames ("checkpoint_names.txt");
+        partialNames.readNameFile(partial);
+        FileReader partialCourses ("checkpoint_courses.txt");
+        CourseRecord record;
+        CourseLoadStats stats = CourseLoadStats();
+        for (int i = 0; i < 3 && partialCourses.readNextCourseRecord(record); ++i) {
+            partialCourses.applyCourseRecord(record, partial);
+        }
+        stats.coursesAdded = 3;
+        size_t offset = 0;
+        for (int line = 0; line < 4; ++line) {
+            offset = courses.find('\n', offset) + 1;
+        }
+        Checkpoint snapshot("checkpoint_test.ckp", "checkpoint_names.txt", "checkpoint_courses.txt", 2);
+        snapshot.save(CHECKPOINT_COURSES, offset, 4, stats, partial);
+
+        std::map<std::string, Student> resumed;
+        Checkpoint checkpoint("checkpoint_test.ckp", "checkpoint_names.txt", "checkpoint_courses.txt", 2);
+        bool loaded = checkpoint.load(resumed) && resumed.size() == 3;
+        FileReader names ("checkpoint_names.txt");
+        names.setCheckpoint(&checkpoint);
+        bool namesSkipped = names.readNameFile(resumed);
+        FileReader resumedCourses ("checkpoint_courses.txt");
+        resumedCourses.setCheckpoint(&checkpoint);
+        resumedCourses.readCourseFile(resumed);
+        std::cerr.rdbuf(saved);
+
+        if (loaded && namesSkipped && rows(resumed) == rows(full) && checkpoint.getLineNumber() == 7)
+            std::cout<<"PASS: Resumed load matches the uninterrupted load"<<std::endl;
+        else
+            std::cout<<"FAIL: Resumed load differs from the uninterrupted load"<<std::endl;
+
+        std::cout<<"--------Testing Snapshot Of Other Inputs Is Ignored--------"<<std::endl;
+        std::ofstream("checkpoint_courses.txt", std::ios::app)<<"\n333333333, CP164, 1, 1, 1, 1\n";
+        std::map<std::string, Student> stale;
+        saved = std::cerr.rdbuf(nullptr);
+        bool ignored = !Checkpoint("checkpoint_test.ckp", "checkpoint_names.txt", "checkpoint_courses.txt", 2).load(stale);
+        std::cerr.rdbuf(saved);
+        if (ignored && stale.empty())
+            std::cout<<"PASS: Checkpoint of changed inputs is not used"<<std::endl;
+        else
+            std::cout<<"FAIL: Stale checkpoint was loaded"<<std::endl;
+
+        std::cout<<"--------Testing Header Counts Are Checked Against The File--------"<<std::endl;
+        // Counts far past the file, ones whose byte total wraps, and a short string section
+        snapshot.save(CHECKPOINT_COURSES, offset, 4, stats, partial);
+        std::string intact = readWholeFile("checkpoint_test.ckp");
+        std::vector<std::pair<size_t, uint64_t>> patches = {
+            {offsetof(CheckpointHeader, studentCount), uint64_t(1) << 60},
+            {offsetof(CheckpointHeader, courseCount), ~uint64_t(0) / sizeof(CheckpointCourse) + 2},
+            {offsetof(CheckpointHeader, stringBytes), 1}};
+        int refused = 0;
+        for (const auto& [field, value] : patches) {
+            std::string damaged = intact;
+            std::memcpy(&damaged[field], &value, sizeof(value));
+            std::ofstream("checkpoint_test.ckp", std::ios::binary | std::ios::trunc)<<damaged;
+            std::map<std::string, Student> loadedBack;
+            std::ostringstream warning;
+            saved = std::cerr.rdbuf(warning.rdbuf());
+            bool used = Checkpoint("checkpoint_test.ckp", "checkpoint_names.txt", "checkpoint_courses.txt", 2).load(loadedBack);
+            std::cerr.rdbuf(saved);
+            refused += !used && loadedBack.empty() && warning.str().find("is malformed, starting over") != std::string::npos;
+        }
+        if (refused == 3)
+            std::cout<<"PASS: Checkpoints whose counts do not fit the file start over"<<std::endl;
+        else
+            std::cout<<"FAIL: Only "<<refused<<" of 3 bad checkpoint headers were refused"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("checkpoint_names.txt");
+    remove("checkpoint_courses.txt");
+    remove("checkpoint_test.ckp");
+
+    std::cout<<"\n";
+}
+
+void testRanking(){
+    std::cout<<"--------TESTING RANKING--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Ranks Against A Brute-Force Count--------"<<std::endl;
+    // 222222222 and 555555555 tie; 666666666 has no courses
+    std::map<std::string, Student> students;
+    const char* rows[][3] = {
+        {"111111111", "CP317", "80"}, {"111111111", "MA200", "60"},
+        {"222222222", "CP317", "90"},
+        {"333333333", "MA200", "50"}, {"333333333", "CP317", "70"},
+        {"444444444", "MA200", "95"},
+        {"555555555", "MA200", "90"},
+    };
+    for (const auto& row : rows) {
+        if (students.count(row[0]) == 0)
+            students.emplace(row[0], Student(row[0], "Student"));
+        float grade = std::stof(row[2]);
+        students[row[0]].addCourse(Course(row[1], grade, grade, grade, grade));
+    }
+    students.emplace("666666666", Student("666666666", "Student"));
+
+    Ranking ranking(students, 4);
+    bool cohortMatches = true, courseMatches = true;
+    for (const auto& [id, student] : students) {
+        size_t index = ranking.indexOf(id);
+        uint32_t expected = 1;
+        for (const auto& [otherID, other] : students)
+            expected += other.getOverallAverage() > student.getOverallAverage();
+        const RankEntry& cohort = ranking.getCohortRank(index);
+        if (cohort.rank != expected || cohort.percentile != 100.0f * (students.size() - expected + 1) / students.size())
+            cohortMatches = false;
+        for (size_t c = 0; c < student.getCourseCount(); ++c) {
+            uint32_t courseExpected = 1;
+            for (const auto& [otherID, other] : students) {
+                if (other.hasCourse(student.getCourses()[c].getCourseCode()))
+                    courseExpected += other.getOverallAverage() > student.getOverallAverage();
+            }
+            if (ranking.getCourseRank(index, c).rank != courseExpected)
+                courseMatches = false;
+        }
+    }
+    if (cohortMatches && courseMatches && ranking.getCohortRank(ranking.indexOf("222222222")).rank == 2
+        && ranking.getCohortRank(ranking.indexOf("555555555")).rank == 2 && ranking.indexOf("999999999") == Ranking::NOT_FOUND)
+        std::cout<<"PASS: Cohort and course ranks match, ties share a rank"<<std::endl;
+    else
+        std::cout<<"FAIL: Ranks differ from the brute-force count"<<std::endl;
+
+    std::cout<<"--------Testing Top-K And Parallel Sort--------"<<std::endl;
+    std::vector<RankedStudent> best = Ranking::top(students, 3);
+    bool topMatches = best.size() == 3 && best[0].student->getStudentID() == "444444444"
+                   && best[1].student->getStudentID() == "222222222" && best[2].student->getStudentID() == "555555555"
+                   && best[2].rank.rank == 2 && Ranking::top(students, 100).size() == students.size();
+
+    std::vector<RankKey> keys(100000);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i].average = static_cast<float>((i * 7919) % 1000) / 10.0f;
+        keys[i].student = static_cast<uint32_t>((i * 104729) % keys.size());
+    }
+    keys[17].average = std::nanf("");
+    std::vector<RankKey> expected = keys;
+    std::sort(expected.begin(), expected.end(), Ranking::before);
+    Ranking::sortKeys(keys, 7);
+    bool sorted = std::equal(keys.begin(), keys.end(), expected.begin(), [](const RankKey& a, const RankKey& b) {
+        return a.student == b.student;
+    }) && keys.back().average != keys.back().average;
+    if (topMatches && sorted)
+        std::cout<<"PASS: Top-K and the parallel sort give the full sort's order"<<std::endl;
+    else
+        std::cout<<"FAIL: Top-K or parallel sort order is wrong"<<std::endl;
+
+    std::cout<<"--------Testing Ranks Follow The Grading Scheme--------"<<std::endl;
+    // The built-in formula puts the test-heavy student first; an exam-only scheme reverses them
+    std::map<std::string, Student> graded;
+    graded["111111111"] = Student("111111111", "Tests");
+    graded["111111111"].addCourse(Course("CP317", 100, 100, 100, 0));
+    graded["222222222"] = Student("222222222", "Exam");
+    graded["222222222"].addCourse(Course("CP317", 0, 0, 0, 100));
+    std::ofstream("ranking_schemes.txt")<<"default, *, 0, 0, 0, 1\n";
+    try{
+        GradeEngine engine;
+        engine.loadConfig("ranking_schemes.txt");
+        Ranking builtIn(graded, 1);
+        Ranking schemed(graded, 1, &engine);
+        std::vector<RankedStudent> best = Ranking::top(graded, 1, &engine);
+        if (builtIn.getCohortRank(0).rank == 1 && schemed.getCohortRank(1).rank == 1 && schemed.getCourseRank(1, 0).rank == 1
+            && best[0].student->getStudentID() == "222222222" && best[0].average == 100.0f)
+            std::cout<<"PASS: Ranks and top averages use the scheme's final grades"<<std::endl;
+        else
+            std::cout<<"FAIL: Ranks ignore the grading scheme"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+    remove("ranking_schemes.txt");
+
+    std::cout<<"\n";
+}
+
+// Everything gzread returns for a file; it reads concatenated members as one stream
+static std::string readGzipFile(const std::string& path) {
+    std::string text;
+    gzFile file = gzopen(path.c_str(), "rb");
+    if (!file) {
+        return text;
+    }
+    char chunk[1 << 16];
+    int length;
+    while ((length = gzread(file, chunk, sizeof(chunk))) > 0) {
+        text.append(chunk, length);
+    }
+    gzclose(file);
+    return text;
+}
+
+void testCompressedOutput(){
+    std::cout<<"--------TESTING COMPRESSED OUTPUT--------"<<std::endl;
+    std::cout<<"\n";
+
+    std::cout<<"--------Testing Gzip Members Decompress To The Plain Output--------"<<std::endl;
+    // Enough students for several blocks, so members are compressed on separate threads
+    std::ofstream names("gzip_names.txt");
+    std::ofstream courses("gzip_courses.txt");
+    for (int s = 0; s < 9000; ++s) {
+        std::string id = std::to_string(100000000 + s);
+        names<<id<<", Student Number "<<s<<"\n";
+        courses<<id<<", CP"<<(100 + s % 7)<<", "<<(s % 101)<<", 80, 90, 65.25\n";
+        courses<<id<<", MA"<<(200 + s % 3)<<", 70.5, "<<(s % 89)<<", 60, 75\n";
+    }
+    names.close();
+    courses.close();
+
+    try{
+        std::map<std::string, Student> students;
+        std::streambuf* saved = std::cerr.rdbuf(nullptr);
+        FileReader nameReader("gzip_names.txt");
+        nameReader.readNameFile(students);
+        FileReader courseReader("gzip_courses.txt");
+        courseReader.readCourseFile(students);
+        std::cerr.rdbuf(saved);
+
+        std::ofstream("gzip_plain.txt").close();
+        std::ofstream("gzip_output.gz").close();
+        FileWriter plain("gzip_plain.txt");
+        plain.writeOutputFile(students);
+        std::string expected = readWholeFile("gzip_plain.txt");
+
+        bool identical = !expected.empty();
+        // One thread cycles a two-block window; eight leave workers with nothing to claim
+        const int levels[] = {GZIP_MIN_LEVEL, 6, GZIP_MAX_LEVEL};
+        const unsigned threadCounts[] = {1, 3, 8};
+        for (int level : levels) {
+            for (unsigned threads : threadCounts) {
+                FileWriter compressed("gzip_output.gz");
+                compressed.writeCompressedOutputFile(students, level, threads);
+                identical = identical && readGzipFile("gzip_output.gz") == expected;
+            }
+        }
+        if (identical)
+            std::cout<<"PASS: Every level and thread count decompresses to the plain output"<<std::endl;
+        else
+            std::cout<<"FAIL: Compressed output differs from the plain output"<<std::endl;
+
+        FileWriter patch;
+        patch.setFileName("gzip_output.gz");
+        std::streambuf* quiet = std::cerr.rdbuf(nullptr);
+        OutputSnapshot snapshot("gzip_output.gz.snapshot");
+        bool refused = !patch.patchOutputFile(students, {"100000000"}, snapshot);
+        std::cerr.rdbuf(quiet);
+        if (refused && readGzipFile("gzip_output.gz") == expected)
+            std::cout<<"PASS: A gzip file is not patched as text"<<std::endl;
+        else
+            std::cout<<"FAIL: Patching rewrote the gzip file"<<std::endl;
+
+        std::map<std::string, Student> none;
+        FileWriter empty("gzip_output.gz");
+        empty.writeCompressedOutputFile(none, 6, 2);
+        std::ifstream emptyFile("gzip_output.gz", std::ios::binary | std::ios::ate);
+        if (emptyFile.tellg() > 0 && readGzipFile("gzip_output.gz").empty())
+            std::cout<<"PASS: No students still gives a valid, empty gzip file"<<std::endl;
+        else
+            std::cout<<"FAIL: Empty output is not a valid gzip file"<<std::endl;
+    }
+    catch(const std::exception& e){
+        std::cout<<"FAIL: Caught unexpected error "<<e.what()<<std::endl;
+    }
+
+    std::cout<<"--------Testing An Invalid Level--------"<<std::endl;
+    try{
+        std::string member;
+        appendGzipMember("rows", 4, 12, member);
+        std::cout<<"FAIL: Level 12 was accepted"<<std::endl;
+    }
+    catch(const CompressionException& e){
+        std::cout<<"PASS: Caught expected error "<<e.what()<<std::endl;
+    }
+    remove("gzip_names.txt");
+    remove("gzip_courses.txt");
+    remove("gzip_plain.txt");
+    remove("gzip_output.gz");
+
+    std::cout<<"\n";
+}
+
 
 int main() {
     //create student objects
@@ -282,6 +2209,31 @@ int main() {
     testCourseStudentExceptionCheck(maxCodes);
     testGradeExceptionCheck();
     testValidStudentExceptionCheck();
+    testColumnarRoundTrip();
+    testParallelWriter();
+    testGradeEngineDefault();
+    testGradeCacheInvalidation();
+    testTranscriptArchive();
+    testBloomFilter();
+    testDatasetPartitions();
+    testConcurrentLoad();
+    testStreamingJoin();
+    testBulkValidation(incorrectCodes, length);
+    testInlineVector();
+    testSamplePreview();
+    testCoordinatorRetry();
+    testCorrectionLog();
+    testNameIndex();
+    testSharedDataset();
+    testRowIndex();
+    testHotPathAllocations();
+    testMemoryAccount();
+    testStageProfiler();
+    testRecordSchema();
+    testRowFilterPushdown();
+    testCheckpointResume();
+    testRanking();
+    testCompressedOutput();
 
 
     return 0;
@@ -1,15 +1,16 @@
 #include "filereader.h"
 #include "exceptions.h"
+#include "bulkvalidation.h"
+#include "dataset.h"
+#include "checkpoint.h"
 #include <iostream>
 #include <vector>
 #include <sstream>
+#include <filesystem>
 
-extern std::string trim(const std::string&);
-extern std::vector<std::string> split(const std::string&, char);
+FileReader::FileReader() : fileName(""), inputFile(), studentFilter(nullptr), rowFilter(nullptr), checkpoint(nullptr), courseStats(), currentLine(0) {}
 
-FileReader::FileReader() : fileName(""), inputFile() {}
-
-FileReader::FileReader(const std::string& name){
+FileReader::FileReader(const std::string& name) : studentFilter(nullptr), rowFilter(nullptr), checkpoint(nullptr), courseStats(), currentLine(0) {
     fileName = name;
     FileExceptionCheck(fileName);           
     inputFile.open(fileName);            
@@ -42,103 +43,372 @@ void FileReader::setFile(const std::string& filename) {
     }
 }
 
-bool FileReader::readNameFile(std::map<std::string, Student>& students) {
-    if (!inputFile.is_open()) {
-        std::cerr << "Cannot open file: " << fileName << std::endl;
-        return false;
-    }
-    
-    std::string line;
-    int lineNumber = 0;
-    
+// Course rows whose ID is definitely not in the filter skip parsing and lookup
+void FileReader::setStudentFilter(const BloomFilter* filter) {
+    studentFilter = filter;
+}
+
+// Rows outside the query's ID range or course codes are dropped as they are
+// tokenized, before their grades are converted or a Course is built
+void FileReader::setRowFilter(const DatasetQuery* query) {
+    rowFilter = query;
+}
+
+// The bulk readers snapshot their progress every so many rows and once at
+// the end, and start from the checkpoint's position when it is in their file
+void FileReader::setCheckpoint(Checkpoint* snapshots) {
+    checkpoint = snapshots;
+}
+
+void FileReader::seekToRow(uint64_t offset, int lineNumber) {
+    inputFile.clear();
+    inputFile.seekg(static_cast<std::streamoff>(offset));
+    currentLine = lineNumber - 1;
+}
+
+// Next non-blank line, counting every line read
+bool FileReader::readNextLine(std::string& line) {
     while (std::getline(inputFile, line)) {
-        lineNumber++;
+        currentLine++;
         
         if (line.empty() || line.find_first_not_of(" \t\r\n") == std::string::npos) {
             continue; // Skip empty lines
         }
-        
+        return true;
+    }
+    return false;
+}
+
+// Byte offset of the next line; tellg would fail once the last line has hit EOF
+uint64_t FileReader::currentOffset() {
+    if (inputFile.eof()) {
+        return std::filesystem::file_size(fileName);
+    }
+    return static_cast<uint64_t>(inputFile.tellg());
+}
+
+bool FileReader::readNextStudent(Student& student) {
+    while (readNextLine(lineBuffer)) {
         try {
-            std::vector<std::string> parts = split(line, ',');
-            if (parts.size() != 2) {
-                std::cerr << "Warning: Invalid format in NameFile.txt at line " << lineNumber 
-                         << ": " << line << std::endl;
+            size_t fieldCount;
+            std::string error;
+            if (NameFileSchema::parse(lineBuffer, nameRecord, fieldCount, error) != RECORD_PARSED) {
+                std::cerr << "Warning: Invalid format in NameFile.txt at line " << currentLine 
+                         << ": " << lineBuffer << std::endl;
                 continue;
             }
             
-            std::string studentID = trim(parts[0]);
-            std::string studentName = trim(parts[1]);
-            
-            if (studentID.empty() || studentName.empty()) {
-                std::cerr << "Warning: Empty ID or name in NameFile.txt at line " << lineNumber << std::endl;
+            if (nameRecord.studentID.empty() || nameRecord.studentName.empty()) {
+                std::cerr << "Warning: Empty ID or name in NameFile.txt at line " << currentLine << std::endl;
+                continue;
+            }
+
+            if (rowFilter && !rowFilter->matchesStudent(nameRecord.studentID)) {
                 continue;
             }
             
-            Student student(studentID, studentName);
-            students[studentID] = student;
+            student = Student(nameRecord.studentID, nameRecord.studentName);
+            return true;
             
         } catch (const std::exception& e) {
-            std::cerr << "Warning: Error processing line " << lineNumber 
+            std::cerr << "Warning: Error processing line " << currentLine 
                      << " in NameFile.txt: " << e.what() << std::endl;
             continue;
         }
     }
+    return false;
+}
+
+bool FileReader::readNameFile(std::map<std::string, Student>& students) {
+    if (!inputFile.is_open()) {
+        std::cerr << "Cannot open file: " << fileName << std::endl;
+        return false;
+    }
+    
+    if (checkpoint && checkpoint->getStage() == CHECKPOINT_COURSES) {
+        inputFile.close();
+        return !students.empty();   // finished before the checkpoint was taken
+    }
+
+    Student student;
+    currentLine = 0;
+    if (checkpoint && checkpoint->getStage() == CHECKPOINT_NAMES) {
+        seekToRow(checkpoint->getOffset(), checkpoint->getLineNumber() + 1);
+    }
+    while (readNextStudent(student)) {
+        students[student.getStudentID()] = std::move(student);
+        if (checkpoint && checkpoint->rowApplied()) {
+            checkpoint->save(CHECKPOINT_NAMES, currentOffset(), currentLine, CourseLoadStats(), students);
+        }
+    }
+    if (checkpoint) {
+        checkpoint->save(CHECKPOINT_COURSES, 0, 0, CourseLoadStats(), students);
+    }
     
     inputFile.close();
     return !students.empty();
 }
 
+void FileReader::parseCourseLine(const std::string& line, int lineNumber, CourseRecord& record) const {
+    record.lineNumber = lineNumber;
+    record.status = COURSE_RECORD_PARSED;
+    record.error.clear();
+    record.prevalidated = false;
+    record.rejectReason = REJECT_NONE;
+
+    // Fields are read in place and assigned into the record's own strings,
+    // which keep their capacity from row to row
+    FieldSpan fields[CourseFileSchema::FIELD_COUNT];
+    record.fieldCount = CourseFileSchema::split(line, fields);
+    if (record.fieldCount != CourseFileSchema::FIELD_COUNT) {
+        record.status = COURSE_RECORD_BAD_FORMAT;
+        return;
+    }
+
+    if (rowFilter && !rowFilter->matchesStudent(fieldText(line, fields[0]))) {
+        record.status = COURSE_RECORD_OUT_OF_RANGE;
+        return;
+    }
+
+    // Rows the filter rejects stop at the ID: their grades are never
+    // converted, so a bad value in one is reported as an unknown student
+    CourseFileSchema::readFields<0, 1>(line, fields, record, record.error);
+    if (studentFilter && !studentFilter->mightContain(record.studentID)) {
+        record.status = COURSE_RECORD_FILTERED;
+        return;
+    }
+
+    if (rowFilter && !rowFilter->matchesCourse(fieldText(line, fields[1]))) {
+        record.status = COURSE_RECORD_UNSELECTED;
+        return;
+    }
+
+    if (!CourseFileSchema::readFields<1>(line, fields, record, record.error)) {
+        record.status = COURSE_RECORD_BAD_VALUE;
+    }
+}
+
+void FileReader::applyCourseRecord(const CourseRecord& record, std::map<std::string, Student>& students, bool quiet) {
+    if (record.status == COURSE_RECORD_OUT_OF_RANGE) {
+        return;
+    }
+    if (record.status == COURSE_RECORD_UNSELECTED) {
+        auto it = students.find(record.studentID);
+        if (it != students.end()) {
+            unselectedRows[&it->second]++;
+        }
+        return;
+    }
+
+    if (record.status == COURSE_RECORD_BAD_FORMAT) {
+        if (!quiet) std::cerr << "Warning: Invalid format in CourseFile.txt at line " << record.lineNumber 
+                 << ": expected " << CourseFileSchema::FIELD_COUNT << " fields, got " << record.fieldCount << std::endl;
+        return;
+    }
+
+    // Staged rows were parsed before the filter existed, so check them here;
+    // a rejected row is reported as an unknown student even if a grade is bad
+    if (studentFilter) {
+        bool rejected = record.status == COURSE_RECORD_FILTERED || !studentFilter->mightContain(record.studentID);
+        if (rejected) {
+            courseStats.filterRejected++;
+            if (!quiet) std::cerr << "Warning: Student ID " << record.studentID 
+                     << " not found in NameFile.txt (line " << record.lineNumber << ")" << std::endl;
+            return;
+        }
+        courseStats.filterPassed++;
+    }
+
+    try {
+        if (record.status == COURSE_RECORD_BAD_VALUE) {
+            throw std::invalid_argument(record.error);
+        }
+
+        // Check if student exists
+        auto it = students.find(record.studentID);
+        if (it != students.end()) {
+            // Unselected rows ahead of this one may have filled the student's
+            // course slots in a full run, which would turn this row away
+            if (!unselectedRows.empty()) {
+                auto skipped = unselectedRows.find(&it->second);
+                if (skipped != unselectedRows.end()
+                    && it->second.getCourseCount() + skipped->second >= Student::MAX_COURSES) {
+                    replayIDs.insert(record.studentID);
+                }
+            }
+            if (record.prevalidated) {
+                BulkValidator::throwReason(static_cast<RejectReason>(record.rejectReason), record.courseCode,
+                                           record.test1, record.test2, record.test3, record.finalExam);
+                it->second.addValidatedCourse(Course::createValidated(record.courseCode, record.test1,
+                                                                      record.test2, record.test3, record.finalExam));
+            } else {
+                it->second.addCourse(Course(record.courseCode, record.test1, record.test2, record.test3, record.finalExam));
+            }
+            courseStats.coursesAdded++;
+        } else {
+            courseStats.filterFalsePositives += studentFilter ? 1 : 0;
+            if (!quiet) std::cerr << "Warning: Student ID " << record.studentID 
+                     << " not found in NameFile.txt (line " << record.lineNumber << ")" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        if (!quiet) std::cerr << "Warning: Error processing line " << record.lineNumber 
+                 << " in CourseFile.txt: " << e.what() << std::endl;
+    }
+}
+
+void FileReader::reportCourseStats() const {
+    std::cout << "Added " << courseStats.coursesAdded << " courses to students" << std::endl;
+    if (studentFilter) {
+        int unknown = courseStats.filterRejected + courseStats.filterFalsePositives;
+        double observed = unknown > 0 ? static_cast<double>(courseStats.filterFalsePositives) / unknown : 0.0;
+        std::cout << "Student prefilter: " << courseStats.filterRejected << " rows skipped, " << courseStats.filterPassed
+                  << " passed, " << courseStats.filterFalsePositives << " false positives (observed rate " << observed
+                  << ", expected " << studentFilter->getExpectedFalsePositiveRate() << ", " << studentFilter->getBitCount()
+                  << " bits, " << studentFilter->getHashCount() << " hashes)" << std::endl;
+    }
+}
+
+bool FileReader::readNextCourseRecord(CourseRecord& record) {
+    if (!readNextLine(lineBuffer)) {
+        return false;
+    }
+    parseCourseLine(lineBuffer, currentLine, record);
+    return true;
+}
+
 bool FileReader::readCourseFile(std::map<std::string, Student>& students) {
     if (!inputFile.is_open()) {
         std::cerr << "Cannot open file: " << fileName << std::endl;
         return false;
     }
     
-    std::string line;
-    int lineNumber = 0;
-    int coursesAdded = 0;
+    CourseRecord record;
+    courseStats = CourseLoadStats();
+    unselectedRows.clear();
+    currentLine = 0;
+    if (checkpoint && checkpoint->getStage() == CHECKPOINT_COURSES) {
+        seekToRow(checkpoint->getOffset(), checkpoint->getLineNumber() + 1);
+        courseStats = checkpoint->getCourseStats();
+    }
     
-    while (std::getline(inputFile, line)) {
-        lineNumber++;
-        
-        if (line.empty() || line.find_first_not_of(" \t\r\n") == std::string::npos) {
-            continue; // Skip empty lines
+    while (readNextCourseRecord(record)) {
+        applyCourseRecord(record, students);
+        if (checkpoint && checkpoint->rowApplied()) {
+            checkpoint->save(CHECKPOINT_COURSES, currentOffset(), currentLine, courseStats, students);
         }
-        
-        try {
-            std::vector<std::string> parts = split(line, ',');
-            if (parts.size() != 6) {
-                std::cerr << "Warning: Invalid format in CourseFile.txt at line " << lineNumber 
-                         << ": expected 6 fields, got " << parts.size() << std::endl;
-                continue;
-            }
-            
-            std::string studentID = trim(parts[0]);
-            std::string courseCode = trim(parts[1]);
-            float test1 = std::stof(trim(parts[2]));
-            float test2 = std::stof(trim(parts[3]));
-            float test3 = std::stof(trim(parts[4]));
-            float finalExam = std::stof(trim(parts[5]));
-            
-            // Check if student exists
-            auto it = students.find(studentID);
-            if (it != students.end()) {
-                Course course(courseCode, test1, test2, test3, finalExam);
-                it->second.addCourse(course);
-                coursesAdded++;
-            } else {
-                std::cerr << "Warning: Student ID " << studentID 
-                         << " not found in NameFile.txt (line " << lineNumber << ")" << std::endl;
+    }
+    if (checkpoint) {
+        checkpoint->save(CHECKPOINT_COURSES, currentOffset(), currentLine, courseStats, students);
+    }
+    
+    inputFile.close();
+    if (!replayIDs.empty()) {
+        replayStudents(students);
+    }
+    reportCourseStats();
+    return courseStats.coursesAdded > 0;
+}
+
+// A student whose selected rows may have been turned away in a full run gets
+// every row of theirs applied again, unfiltered and in file order, and then
+// keeps only the selected courses, exactly as filtering a full run would
+void FileReader::replayStudents(std::map<std::string, Student>& students) {
+    std::map<std::string, Student> replayed;
+    for (const auto& id : replayIDs) {
+        const Student& student = students.at(id);
+        replayed.emplace(id, Student(student.getStudentID(), student.getStudentName()));
+    }
+
+    const DatasetQuery* query = rowFilter;
+    CourseLoadStats stats = courseStats;
+    rowFilter = nullptr;
+    // The replayed rows already reported their warnings
+    inputFile.open(fileName);
+    currentLine = 0;
+    CourseRecord record;
+    FieldSpan fields[CourseFileSchema::FIELD_COUNT];
+    while (readNextLine(lineBuffer)) {
+        bool replay = CourseFileSchema::split(lineBuffer, fields) == CourseFileSchema::FIELD_COUNT
+                   && replayIDs.count(fieldText(lineBuffer, fields[0])) > 0;
+        if (replay) {
+            parseCourseLine(lineBuffer, currentLine, record);
+            applyCourseRecord(record, replayed, true);
+        }
+    }
+    inputFile.close();
+    rowFilter = query;
+    courseStats = stats;
+
+    for (auto& [id, student] : replayed) {
+        std::vector<std::string> unselected;
+        for (const auto& course : student.getCourses()) {
+            if (!rowFilter->matchesCourse(course.getCourseCode())) {
+                unselected.push_back(course.getCourseCode());
             }
-            
-        } catch (const std::exception& e) {
-            std::cerr << "Warning: Error processing line " << lineNumber 
-                     << " in CourseFile.txt: " << e.what() << std::endl;
-            continue;
         }
+        for (const auto& code : unselected) {
+            student.removeCourse(code);
+        }
+        students[id] = std::move(student);
     }
-    
+    replayIDs.clear();
+}
+
+// Runs before the student directory exists, so it only parses; nothing is
+// printed here and unknown students are left for joinCourseRecords
+bool FileReader::stageCourseFile(std::vector<CourseRecord>& staged) {
+    if (!inputFile.is_open() && !fileName.empty()) {
+        inputFile.open(fileName);
+    }
+    if (!inputFile.is_open()) {
+        return false;
+    }
+
+    currentLine = 0;
+    staged.emplace_back();
+    while (readNextCourseRecord(staged.back())) {
+        staged.emplace_back();
+    }
+    staged.pop_back();
+
     inputFile.close();
-    std::cout << "Added " << coursesAdded << " courses to students" << std::endl;
-    return coursesAdded > 0;
-}
\ No newline at end of file
+    return true;
+}
+
+size_t FileReader::validateCourseRecords(std::vector<CourseRecord>& staged) {
+    std::vector<size_t> rows;
+    rows.reserve(staged.size());
+    for (size_t i = 0; i < staged.size(); ++i) {
+        if (staged[i].status == COURSE_RECORD_PARSED) {
+            rows.push_back(i);
+        }
+    }
+
+    BulkValidator validator;
+    validator.resize(rows.size());
+    for (size_t r = 0; r < rows.size(); ++r) {
+        const CourseRecord& record = staged[rows[r]];
+        validator.setRow(r, record.courseCode, record.test1, record.test2, record.test3, record.finalExam);
+    }
+    validator.validate();
+
+    for (size_t r = 0; r < rows.size(); ++r) {
+        staged[rows[r]].prevalidated = true;
+        staged[rows[r]].rejectReason = validator.getReason(r);
+    }
+    return validator.getRejectedCount();
+}
+
+bool FileReader::joinCourseRecords(const std::vector<CourseRecord>& staged, std::map<std::string, Student>& students) {
+    if (inputFile.is_open()) {
+        inputFile.close();
+    }
+
+    courseStats = CourseLoadStats();
+    for (const auto& record : staged) {
+        applyCourseRecord(record, students);
+    }
+
+    reportCourseStats();
+    return courseStats.coursesAdded > 0;
+}
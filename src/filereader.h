@@ -4,12 +4,88 @@
 #include <fstream>
 #include <string>
 #include <map>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <cstdint>
 #include "student.h"
+#include "bloomfilter.h"
+#include "recordschema.h"
+
+struct DatasetQuery;
+class Checkpoint;
+
+// One CourseFile.txt row, parsed but not yet joined to its student
+enum CourseRecordStatus {
+    COURSE_RECORD_PARSED,
+    COURSE_RECORD_BAD_FORMAT,   // wrong field count
+    COURSE_RECORD_BAD_VALUE,    // a grade failed to convert
+    COURSE_RECORD_FILTERED,     // student ID rejected by the prefilter
+    COURSE_RECORD_OUT_OF_RANGE, // student ID outside the row filter; nothing converted
+    COURSE_RECORD_UNSELECTED    // course code not selected; only the ID converted
+};
+
+struct CourseRecord {
+    int lineNumber;
+    CourseRecordStatus status;
+    size_t fieldCount;
+    std::string studentID;
+    std::string courseCode;
+    float test1, test2, test3, finalExam;
+    std::string error;
+    bool prevalidated;          // grades and code checked by BulkValidator
+    uint8_t rejectReason;       // RejectReason when prevalidated
+};
+
+// One NameFile.txt row
+struct NameRecord {
+    std::string studentID;
+    std::string studentName;
+};
+
+// Input layouts; validation stays with Student and Course (and BulkValidator),
+// which report it in the order the warnings have always come in
+typedef RecordSchema<NameRecord, ',',
+    Field<TextField, &NameRecord::studentID>,
+    Field<TextField, &NameRecord::studentName>> NameFileSchema;
+
+typedef RecordSchema<CourseRecord, ',',
+    Field<TextField, &CourseRecord::studentID>,
+    Field<TextField, &CourseRecord::courseCode>,
+    Field<FloatField, &CourseRecord::test1>,
+    Field<FloatField, &CourseRecord::test2>,
+    Field<FloatField, &CourseRecord::test3>,
+    Field<FloatField, &CourseRecord::finalExam>> CourseFileSchema;
+
+struct CourseLoadStats {
+    int coursesAdded;
+    int filterRejected;
+    int filterPassed;
+    int filterFalsePositives;
+};
 
 class FileReader{
     private:
         std::string fileName;
         std::ifstream inputFile;
+        const BloomFilter* studentFilter;
+        const DatasetQuery* rowFilter;
+        Checkpoint* checkpoint;
+        CourseLoadStats courseStats;
+
+        // Course rows the row filter skipped per student, and the students
+        // they may have left short of a full run's courses (see replayStudents)
+        std::unordered_map<const Student*, size_t> unselectedRows;
+        std::set<std::string, std::less<>> replayIDs;
+        int currentLine;
+
+        // Reused across rows so steady-state reading does not allocate
+        std::string lineBuffer;
+        NameRecord nameRecord;
+
+        bool readNextLine(std::string& line);
+        uint64_t currentOffset();
+        void replayStudents(std::map<std::string, Student>& students);
 
     public:
         FileReader();
@@ -22,9 +98,34 @@ class FileReader{
 
         void setFileName(const std::string& name);
         void setFile (const std::string& filename);
+        void setStudentFilter(const BloomFilter* filter);
+        void setRowFilter(const DatasetQuery* query);
+        void setCheckpoint(Checkpoint* snapshots);
 
         bool readNameFile (std::map<std::string, Student>& students);
         bool readCourseFile(std::map<std::string, Student>& students);
+
+        // Concurrent loading: stage CourseFile rows while NameFile loads, then
+        // join them with the same warnings and results as readCourseFile
+        bool stageCourseFile(std::vector<CourseRecord>& staged);
+        bool joinCourseRecords(const std::vector<CourseRecord>& staged, std::map<std::string, Student>& students);
+
+        // Validates every staged row in one columnar pass; returns the reject count
+        static size_t validateCourseRecords(std::vector<CourseRecord>& staged);
+
+        // Row-at-a-time reading for streaming joins; warnings match the bulk readers
+        bool readNextStudent(Student& student);
+        bool readNextCourseRecord(CourseRecord& record);
+        // quiet skips the warnings, for rows applied again after they already reported them
+        void applyCourseRecord(const CourseRecord& record, std::map<std::string, Student>& students, bool quiet = false);
+        void reportCourseStats() const;
+
+        // Positions the reader at a row found through a RowIndex, so the next
+        // readNextStudent/readNextCourseRecord reads that row with its line number
+        void seekToRow(uint64_t offset, int lineNumber);
+
+        // Parses one CourseFile.txt line without touching any student
+        void parseCourseLine(const std::string& line, int lineNumber, CourseRecord& record) const;
 };
 
 #endif
\ No newline at end of file
@@ -1,16 +1,33 @@
 #include "filewriter.h"
 #include "exceptions.h"
+#include "columnar.h"
+#include "gzipblock.h"
 #include <iostream>
+#include <filesystem>
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <cstdio>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 extern std::string trim(const std::string&);
 extern std::vector<std::string> split(const std::string&, char);
 
-FileWriter::FileWriter() : fileName(""), outputFile() {}
+// Students per gzip block, about half a megabyte of rows. Deflate looks back
+// only 32 KB, so blocks this size compress almost as well as one stream
+static const size_t GZIP_BLOCK_STUDENTS = 4096;
 
-FileWriter::FileWriter(const std::string& name){
+FileWriter::FileWriter() : fileName(""), outputFile(), gradeEngine(nullptr), ranking(nullptr) {}
+
+FileWriter::FileWriter(const std::string& name) : gradeEngine(nullptr), ranking(nullptr) {
     fileName = name;
     FileExceptionCheck(fileName);           
     outputFile.open(fileName);            
@@ -41,6 +58,76 @@ void FileWriter::setFile(const std::string& name) {
     }
 }
 
+void FileWriter::setGradeEngine(const GradeEngine* engine) {
+    gradeEngine = engine;
+}
+
+// Adds the rank and percentile columns to Output.txt rows
+void FileWriter::setRanking(const Ranking* ranks) {
+    ranking = ranks;
+}
+
+// Output.txt uses the "default" scheme when a grading config is loaded
+float FileWriter::getFinalGrade(const Course& course) const {
+    if (gradeEngine && !gradeEngine->usesBuiltInFormula()) {
+        return gradeEngine->calculateFinalGrade(course);
+    }
+    return course.calculateFinalGrade();
+}
+
+// One Output.txt row without its newline; "%.1f" gives the same bytes as
+// std::fixed with setprecision(1)
+static void appendOutputFields(std::string& buffer, std::string_view studentID, std::string_view studentName,
+                               std::string_view courseCode, float finalGrade) {
+    char grade[32];
+    int length = std::snprintf(grade, sizeof(grade), "%.1f", static_cast<double>(finalGrade));
+    buffer += studentID;
+    buffer += ", ";
+    buffer += studentName;
+    buffer += ", ";
+    buffer += courseCode;
+    buffer += ", ";
+    buffer.append(grade, length);
+}
+
+static void appendOutputRow(std::string& buffer, std::string_view studentID, std::string_view studentName,
+                            std::string_view courseCode, float finalGrade) {
+    appendOutputFields(buffer, studentID, studentName, courseCode, finalGrade);
+    buffer += '\n';
+}
+
+static void appendRankColumns(std::string& buffer, const RankEntry& entry) {
+    char columns[48];
+    int length = std::snprintf(columns, sizeof(columns), ", %u, %.1f", static_cast<unsigned>(entry.rank),
+                               static_cast<double>(entry.percentile));
+    buffer.append(columns, length);
+}
+
+// A student's Output.txt rows; with a ranking each row ends with the
+// student's cohort rank and percentile, then those within the course
+void FileWriter::appendStudentRows(std::string& buffer, const Student& student) const {
+    size_t index = ranking ? ranking->indexOf(student.getStudentID()) : Ranking::NOT_FOUND;
+    const Student::CourseList& courses = student.getCourses();
+    for (size_t c = 0; c < courses.size(); ++c) {
+        appendOutputFields(buffer, student.getStudentID(), student.getStudentName(), courses[c].getCourseCode(),
+                           getFinalGrade(courses[c]));
+        if (index != Ranking::NOT_FOUND) {
+            appendRankColumns(buffer, ranking->getCohortRank(index));
+            appendRankColumns(buffer, ranking->getCourseRank(index, c));
+        }
+        buffer += '\n';
+    }
+}
+
+// One student's Output.txt rows; the file stays open for the next student.
+// Rows go through one reused buffer, so a student costs no allocations
+bool FileWriter::writeStudentRows(const Student& student) {
+    rowBuffer.clear();
+    appendStudentRows(rowBuffer, student);
+    outputFile.write(rowBuffer.data(), rowBuffer.size());
+    return static_cast<bool>(outputFile);
+}
+
 bool FileWriter::writeOutputFile(const std::map<std::string, Student>& students) {
     if (!outputFile.is_open()) {
         std::cerr << "Cannot create output file: " << fileName << std::endl;
@@ -49,14 +136,456 @@ bool FileWriter::writeOutputFile(const std::map<std::string, Student>& students)
     
     //write students to output file
     for (const auto& [id, student] : students) {
-        const std::vector<Course>& courses = student.getCourses(); 
-        for (const auto& course : courses) {
-            double final = course.calculateFinalGrade();
-            outputFile << student.getStudentID() << ", " << student.getStudentName() << ", " << course.getCourseCode() << ", " << std::fixed << std::setprecision(1) << final << std::endl;
-        }
+        writeStudentRows(student);
     }
     
     outputFile.close();
     std::cout << "Wrote records to " << fileName << std::endl;
     return true;
+}
+
+// Copies count bytes from in at start to the end of out
+static bool copyBytes(std::istream& in, std::ostream& out, uint64_t start, uint64_t count) {
+    char buffer[65536];
+    in.seekg(start);
+    while (count > 0 && in) {
+        std::streamsize chunk = static_cast<std::streamsize>(std::min<uint64_t>(count, sizeof(buffer)));
+        in.read(buffer, chunk);
+        out.write(buffer, in.gcount());
+        count -= in.gcount();
+    }
+    return count == 0 && static_cast<bool>(out);
+}
+
+// Rewrites only the changed students' rows, at the spans the snapshot holds for
+// them; students is only those the snapshot gave back. Rows that keep their
+// length are overwritten in place. Once a student's rows grow or shrink,
+// everything after them moves, so that tail is rebuilt in a temporary file,
+// copied back and the file cut to its new length. A run that dies part way
+// leaves an output the manifest no longer matches, so the next run rewrites it.
+bool FileWriter::patchOutputFile(const std::map<std::string, Student>& students, const std::set<std::string>& changed,
+                                 OutputSnapshot& snapshot) {
+    if (outputFile.is_open()) {
+        outputFile.close();
+    }
+    std::fstream file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open file: " << fileName << std::endl;
+        return false;
+    }
+    // Rows are patched as text; a gzip stream must be written again in full
+    char magic[2] = {0, 0};
+    file.read(magic, sizeof(magic));
+    if (magic[0] == '\x1f' && magic[1] == '\x8b') {
+        std::cerr << "Cannot patch compressed file: " << fileName << std::endl;
+        return false;
+    }
+    if (!snapshot.hasRowIndex()) {
+        std::cerr << "Cannot patch file: " << fileName << " has no row offsets in " << snapshot.getPath() << std::endl;
+        return false;
+    }
+    file.clear();
+
+    // IDs sort the same way the rows lie in the file
+    std::map<std::string, std::string> rows;
+    std::map<std::string, uint64_t> lengths;
+    size_t rowsWritten = 0;
+    for (const auto& id : changed) {
+        auto it = students.find(id);
+        if (it == students.end()) {
+            continue;
+        }
+        std::string& text = rows[id];
+        appendStudentRows(text, it->second);
+        lengths[id] = text.size();
+        rowsWritten += it->second.getCourseCount();
+    }
+    auto firstMoved = std::find_if(rows.begin(), rows.end(), [&snapshot](const auto& row) {
+        return row.second.size() != snapshot.getSpan(row.first).length;
+    });
+
+    for (auto it = rows.begin(); it != firstMoved; ++it) {
+        file.seekp(snapshot.getSpan(it->first).offset);
+        file.write(it->second.data(), it->second.size());
+    }
+
+    uint64_t bytesMoved = 0;
+    if (firstMoved != rows.end()) {
+        uint64_t fileSize = std::filesystem::file_size(fileName);
+        uint64_t start = snapshot.getSpan(firstMoved->first).offset;
+        std::string temporary = fileName + ".tmp";
+        std::fstream tail(temporary, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!tail.is_open()) {
+            throw FileAccessException(temporary);
+        }
+        uint64_t position = start;
+        bool copied = true;
+        for (auto it = firstMoved; it != rows.end(); ++it) {
+            OutputSpan span = snapshot.getSpan(it->first);
+            copied = copied && copyBytes(file, tail, position, span.offset - position);
+            tail.write(it->second.data(), it->second.size());
+            position = span.offset + span.length;
+        }
+        copied = copied && copyBytes(file, tail, position, fileSize - position);
+        bytesMoved = static_cast<uint64_t>(tail.tellp());
+        file.clear();
+        file.seekp(start);
+        copied = copied && copyBytes(tail, file, 0, bytesMoved);
+        tail.close();
+        std::remove(temporary.c_str());
+        file.close();
+        if (!copied || !file) {
+            throw FileAccessException(fileName);
+        }
+        std::filesystem::resize_file(fileName, start + bytesMoved);
+    } else {
+        file.close();
+        if (!file) {
+            throw FileAccessException(fileName);
+        }
+    }
+
+    if (!snapshot.update(students, lengths)) {
+        return false;
+    }
+    std::cout << "Patched " << fileName << ": " << rowsWritten << " rows regenerated for " << changed.size()
+              << " students, " << bytesMoved << " bytes moved" << std::endl;
+    return true;
+}
+
+bool FileWriter::writeOutputFileParallel(const std::map<std::string, Student>& students, unsigned threadCount) {
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+
+    // Split the ID-sorted range into contiguous partitions of roughly equal row counts
+    std::vector<const Student*> ordered;
+    size_t totalRows = 0;
+    ordered.reserve(students.size());
+    for (const auto& [id, student] : students) {
+        ordered.push_back(&student);
+        totalRows += student.getCourseCount();
+    }
+
+    std::vector<size_t> bounds(1, 0);
+    size_t rowsSeen = 0;
+    for (size_t i = 0; i < ordered.size() && bounds.size() < threadCount; ++i) {
+        rowsSeen += ordered[i]->getCourseCount();
+        if (rowsSeen * threadCount >= totalRows * bounds.size()) {
+            bounds.push_back(i + 1);
+        }
+    }
+    if (bounds.back() != ordered.size()) {
+        bounds.push_back(ordered.size());
+    }
+    size_t partitions = bounds.size() - 1;
+
+    // Each thread formats its partition into its own buffer
+    std::vector<std::string> buffers(partitions);
+    std::vector<std::thread> workers;
+    for (size_t p = 0; p < partitions; ++p) {
+        workers.emplace_back([&, p]() {
+            for (size_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+                appendStudentRows(buffers[p], *ordered[i]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Prefix sums of the buffer sizes give each partition its file offset
+    std::vector<size_t> offsets(partitions + 1, 0);
+    for (size_t p = 0; p < partitions; ++p) {
+        offsets[p + 1] = offsets[p] + buffers[p].size();
+    }
+
+    if (outputFile.is_open()) {
+        outputFile.close();
+    }
+
+#ifdef _WIN32
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(fileName);
+    }
+    for (const auto& buffer : buffers) {
+        out.write(buffer.data(), buffer.size());
+    }
+    if (!out) {
+        throw FileAccessException(fileName);
+    }
+#else
+    int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw FileAccessException(fileName);
+    }
+    if (::ftruncate(fd, offsets[partitions]) != 0) {
+        ::close(fd);
+        throw FileAccessException(fileName);
+    }
+
+    // Threads write their buffers in place at the precomputed offsets
+    std::vector<char> failed(partitions, 0);
+    workers.clear();
+    for (size_t p = 0; p < partitions; ++p) {
+        workers.emplace_back([&, p]() {
+            const char* data = buffers[p].data();
+            size_t remaining = buffers[p].size();
+            off_t position = static_cast<off_t>(offsets[p]);
+            while (remaining > 0) {
+                ssize_t n = ::pwrite(fd, data, remaining, position);
+                if (n <= 0) {
+                    failed[p] = 1;
+                    return;
+                }
+                data += n;
+                remaining -= n;
+                position += n;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    bool ok = ::close(fd) == 0;
+    for (char f : failed) {
+        ok = ok && !f;
+    }
+    if (!ok) {
+        throw FileAccessException(fileName);
+    }
+#endif
+
+    std::cout << "Wrote records to " << fileName << " using " << partitions << " threads" << std::endl;
+    return true;
+}
+
+// Output.txt as gzip: threads take the next block of students, format its
+// rows and deflate them into a member of their own; members are written in
+// block order. Blocks go a window at a time, so memory stays at two blocks
+// per thread however large the file.
+bool FileWriter::writeCompressedOutputFile(const std::map<std::string, Student>& students, int level,
+                                           unsigned threadCount) {
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    std::vector<const Student*> ordered;
+    ordered.reserve(students.size());
+    for (const auto& [id, student] : students) {
+        ordered.push_back(&student);
+    }
+    size_t blockCount = (ordered.size() + GZIP_BLOCK_STUDENTS - 1) / GZIP_BLOCK_STUDENTS;
+
+    // Binary output, so the text stream opened by the constructor is not used
+    if (outputFile.is_open()) {
+        outputFile.close();
+    }
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(fileName);
+    }
+
+    // Workers live for the whole file and claim blocks in order, at most window ahead of
+    // the writer; this thread writes each member as soon as it and every earlier one are done
+    size_t window = 2 * static_cast<size_t>(threadCount);
+    std::vector<std::string> members(window);
+    std::vector<char> compressed(window, false);
+    size_t nextBlock = 0, writtenBlocks = 0;
+    bool stopping = false;
+    std::exception_ptr failure;
+    std::mutex lock;
+    std::condition_variable memberReady, slotFree;
+
+    auto compressBlocks = [&]() {
+        std::string rows, member;
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            slotFree.wait(guard, [&]() {
+                return stopping || nextBlock >= blockCount || nextBlock < writtenBlocks + window;
+            });
+            if (stopping || nextBlock >= blockCount) {
+                return;
+            }
+            size_t b = nextBlock++;
+            guard.unlock();
+            try {
+                rows.clear();
+                member.clear();
+                size_t end = std::min(ordered.size(), (b + 1) * GZIP_BLOCK_STUDENTS);
+                for (size_t i = b * GZIP_BLOCK_STUDENTS; i < end; ++i) {
+                    appendStudentRows(rows, *ordered[i]);
+                }
+                appendGzipMember(rows.data(), rows.size(), level, member);
+                guard.lock();
+            } catch (...) {
+                guard.lock();
+                failure = std::current_exception();
+                stopping = true;
+                memberReady.notify_all();
+                slotFree.notify_all();
+                return;
+            }
+            // The slot's old buffer comes back, so steady state reuses allocations
+            members[b % window].swap(member);
+            compressed[b % window] = true;
+            memberReady.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount && t < blockCount; ++t) {
+        workers.emplace_back(compressBlocks);
+    }
+    std::string member;
+    for (size_t b = 0; b < blockCount; ++b) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            memberReady.wait(guard, [&]() { return compressed[b % window] || failure; });
+            if (failure) {
+                break;
+            }
+            member.swap(members[b % window]);
+            compressed[b % window] = false;
+            writtenBlocks = b + 1;
+        }
+        slotFree.notify_all();
+        out.write(member.data(), member.size());
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    // gzip rejects an empty file, so no students still gets one empty member
+    if (blockCount == 0) {
+        appendGzipMember("", 0, level, members[0]);
+        out.write(members[0].data(), members[0].size());
+    }
+    out.close();
+    if (!out) {
+        throw FileAccessException(fileName);
+    }
+    std::cout << "Wrote records to " << fileName << " as " << std::max<size_t>(1, blockCount)
+              << " gzip blocks at level " << level << " using " << threadCount << " threads" << std::endl;
+    return true;
+}
+
+bool FileWriter::writeColumnarFile(const std::map<std::string, Student>& students) {
+    if (fileName.empty()) {
+        std::cerr << "Cannot create columnar file: no file name set" << std::endl;
+        return false;
+    }
+
+    // Binary output, so the text stream opened by the constructor is not used
+    if (outputFile.is_open()) {
+        outputFile.close();
+    }
+
+    ColumnarTable table = buildColumnarTable(students, gradeEngine);
+    ::writeColumnarFile(fileName, table);
+    std::cout << "Wrote " << table.rowCount() << " columnar records to " << fileName << std::endl;
+    return true;
+}
+
+bool FileWriter::writeWhatIfFile(const std::map<std::string, Student>& students) {
+    if (!outputFile.is_open() && !fileName.empty()) {
+        outputFile.open(fileName);
+    }
+    if (!outputFile.is_open()) {
+        std::cerr << "Cannot create what-if file: " << fileName << std::endl;
+        return false;
+    }
+
+    GradeEngine builtIn;
+    const GradeEngine& engine = gradeEngine ? *gradeEngine : builtIn;
+    size_t schemeCount = engine.getSchemeCount();
+
+    // Every scheme is evaluated in one pass, then written next to each other
+    std::vector<float> grades;
+    size_t rows = engine.evaluateAll(students, grades);
+
+    outputFile << "StudentID, StudentName, CourseCode";
+    for (size_t s = 0; s < schemeCount; ++s) {
+        outputFile << ", " << engine.getSchemeName(s);
+    }
+    outputFile << "\n" << std::fixed << std::setprecision(1);
+
+    size_t row = 0;
+    for (const auto& [id, student] : students) {
+        for (const auto& course : student.getCourses()) {
+            outputFile << student.getStudentID() << ", " << student.getStudentName() << ", " << course.getCourseCode();
+            for (size_t s = 0; s < schemeCount; ++s) {
+                outputFile << ", " << static_cast<double>(grades[row * schemeCount + s]);
+            }
+            outputFile << "\n";
+            row++;
+        }
+    }
+
+    outputFile.close();
+    std::cout << "Wrote " << rows << " what-if records for " << schemeCount << " schemes to " << fileName << std::endl;
+    return true;
+}
+
+// Output.txt straight from a shared-memory dataset; nothing is parsed or copied
+bool FileWriter::writeSharedOutputFile(const SharedDatasetView& dataset) {
+    if (!outputFile.is_open()) {
+        std::cerr << "Cannot create output file: " << fileName << std::endl;
+        return false;
+    }
+
+    std::string buffer;
+    for (size_t s = 0; s < dataset.getStudentCount(); ++s) {
+        const SharedStudent& student = dataset.studentAt(s);
+        for (uint64_t c = student.firstCourse; c < student.firstCourse + student.courseCount; ++c) {
+            const SharedCourse& course = dataset.courseAt(c);
+            appendOutputRow(buffer, dataset.studentID(student), dataset.studentName(student),
+                            dataset.courseCode(course), getFinalGrade(dataset.makeCourse(course)));
+        }
+        if (buffer.size() >= (1 << 16)) {
+            outputFile.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    outputFile.write(buffer.data(), buffer.size());
+
+    outputFile.close();
+    std::cout << "Wrote records to " << fileName << std::endl;
+    return static_cast<bool>(outputFile);
+}
+
+bool FileWriter::writeDatasetFile(const std::vector<TermPartition>& partitions, const DatasetQuery& query) {
+    if (!outputFile.is_open() && !fileName.empty()) {
+        outputFile.open(fileName);
+    }
+    if (!outputFile.is_open()) {
+        std::cerr << "Cannot create dataset output file: " << fileName << std::endl;
+        return false;
+    }
+
+    // Output.txt rows prefixed with the term, ordered by term then student ID
+    size_t rows = 0;
+    outputFile << std::fixed << std::setprecision(1);
+    for (const auto& partition : partitions) {
+        for (const auto& [id, student] : partition.students) {
+            if (!query.matchesStudent(id)) {
+                continue;
+            }
+            for (const auto& course : student.getCourses()) {
+                if (!query.matchesCourse(course.getCourseCode())) {
+                    continue;
+                }
+                outputFile << partition.metadata.term << ", " << student.getStudentID() << ", " << student.getStudentName()
+                           << ", " << course.getCourseCode() << ", " << static_cast<double>(getFinalGrade(course)) << "\n";
+                rows++;
+            }
+        }
+    }
+
+    outputFile.close();
+    std::cout << "Wrote " << rows << " records from " << partitions.size() << " terms to " << fileName << std::endl;
+    return true;
 }
\ No newline at end of file
@@ -4,12 +4,24 @@
 #include <fstream>
 #include <string>
 #include <map>
+#include <set>
 #include "student.h"
+#include "gradeengine.h"
+#include "dataset.h"
+#include "shareddataset.h"
+#include "ranking.h"
+#include "outputsnapshot.h"
 
 class FileWriter{
     private:
         std::string fileName;
         std::ofstream outputFile;
+        const GradeEngine* gradeEngine;
+        const Ranking* ranking;
+        std::string rowBuffer;          // reused by writeStudentRows
+
+        float getFinalGrade(const Course& course) const;
+        void appendStudentRows(std::string& buffer, const Student& student) const;
 
     public:
         FileWriter();
@@ -22,8 +34,19 @@ class FileWriter{
 
         void setFileName(const std::string& name);
         void setFile(const std::string& filename);
+        void setGradeEngine(const GradeEngine* engine);
+        void setRanking(const Ranking* ranks);
 
         bool writeOutputFile(const std::map<std::string, Student>& students);
+        bool writeStudentRows(const Student& student);
+        bool patchOutputFile(const std::map<std::string, Student>& students, const std::set<std::string>& changed,
+                             OutputSnapshot& snapshot);
+        bool writeOutputFileParallel(const std::map<std::string, Student>& students, unsigned threadCount);
+        bool writeCompressedOutputFile(const std::map<std::string, Student>& students, int level, unsigned threadCount);
+        bool writeColumnarFile(const std::map<std::string, Student>& students);
+        bool writeWhatIfFile(const std::map<std::string, Student>& students);
+        bool writeSharedOutputFile(const SharedDatasetView& dataset);
+        bool writeDatasetFile(const std::vector<TermPartition>& partitions, const DatasetQuery& query);
 };
 
 #endif
\ No newline at end of file
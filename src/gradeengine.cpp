@@ -0,0 +1,209 @@
+#include "gradeengine.h"
+#include "exceptions.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+extern std::string trim(const std::string&);
+extern std::vector<std::string> split(const std::string&, char);
+
+static const int LETTERS = 52;
+static const size_t DIGIT_CODES = 1000;
+
+GradeWeights::GradeWeights() : GradeWeights(0.20f, 0.20f, 0.20f, 0.40f) {}
+
+GradeWeights::GradeWeights(float t1, float t2, float t3, float exam)
+    : test1(t1), test2(t2), test3(t3), finalExam(exam), groupedTests(t1 == t2 && t2 == t3) {}
+
+GradeEngine::GradeEngine() : weights(1) {
+    CompiledScheme scheme;
+    scheme.name = "default";
+    compile(scheme, {});
+    schemes.push_back(std::move(scheme));
+}
+
+int GradeEngine::letterIndex(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return 26 + (c - 'a');
+    return -1;
+}
+
+static bool isDigits(const std::string& s, size_t from) {
+    for (size_t i = from; i < s.size(); ++i) {
+        if (s[i] < '0' || s[i] > '9') return false;
+    }
+    return true;
+}
+
+void GradeEngine::compile(CompiledScheme& scheme, std::vector<Rule> rules) {
+    scheme.pairRule.assign(LETTERS * LETTERS, 0);
+    scheme.digitRules.clear();
+    scheme.digitRules.resize(LETTERS * LETTERS);
+
+    // Shorter matches first so longer ones overwrite them
+    std::stable_sort(rules.begin(), rules.end(), [](const Rule& a, const Rule& b) {
+        size_t la = a.match == "*" ? 0 : a.match.size();
+        size_t lb = b.match == "*" ? 0 : b.match.size();
+        return la < lb;
+    });
+
+    for (const Rule& rule : rules) {
+        uint16_t index = static_cast<uint16_t>(weights.size());
+        weights.push_back(rule.weights);
+        const std::string& m = rule.match;
+
+        if (m == "*") {
+            std::fill(scheme.pairRule.begin(), scheme.pairRule.end(), index);
+        } else if (m.size() == 1) {
+            int first = letterIndex(m[0]);
+            for (int second = 0; second < LETTERS; ++second) {
+                scheme.pairRule[first * LETTERS + second] = index;
+            }
+        } else {
+            int pair = letterIndex(m[0]) * LETTERS + letterIndex(m[1]);
+            if (m.size() == 2) {
+                scheme.pairRule[pair] = index;
+                continue;
+            }
+            auto& table = scheme.digitRules[pair];
+            if (!table) {
+                table.reset(new std::vector<uint16_t>(DIGIT_CODES, scheme.pairRule[pair]));
+            }
+            // "CP3" covers 300-399, "CP31" covers 310-319, "CP317" covers 317
+            size_t span = 1;
+            for (size_t i = m.size(); i < 5; ++i) span *= 10;
+            size_t start = std::stoul(m.substr(2)) * span;
+            std::fill(table->begin() + start, table->begin() + start + span, index);
+        }
+    }
+}
+
+uint16_t GradeEngine::ruleFor(const CompiledScheme& scheme, const std::string& code) const {
+    if (code.size() != 5) return 0;
+    int first = letterIndex(code[0]);
+    int second = letterIndex(code[1]);
+    if (first < 0 || second < 0) return 0;
+
+    int pair = first * LETTERS + second;
+    const auto& table = scheme.digitRules[pair];
+    if (!table) return scheme.pairRule[pair];
+    return (*table)[(code[2] - '0') * 100 + (code[3] - '0') * 10 + (code[4] - '0')];
+}
+
+void GradeEngine::loadConfig(const std::string& filename) {
+    FileExceptionCheck(filename);
+    std::ifstream file(filename);
+
+    std::vector<std::string> names = {"default"};
+    std::map<std::string, std::vector<Rule>> rules;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::string content = trim(line);
+        if (content.empty() || content[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> parts = split(content, ',');
+        std::string where = filename + " line " + std::to_string(lineNumber);
+        if (parts.size() != 6)
+            throw GradeSchemeException(where + ": expected 6 fields, got " + std::to_string(parts.size()));
+
+        std::string name = trim(parts[0]);
+        std::string match = trim(parts[1]);
+        bool validMatch = match == "*" ||
+            (match.size() >= 1 && match.size() <= 5 && letterIndex(match[0]) >= 0 &&
+             (match.size() == 1 || letterIndex(match[1]) >= 0) && isDigits(match, 2));
+        if (name.empty() || !validMatch)
+            throw GradeSchemeException(where + ": invalid scheme name or match '" + match + "'");
+
+        float w[4];
+        try {
+            for (int i = 0; i < 4; ++i) {
+                w[i] = std::stof(trim(parts[i + 2]));
+            }
+        } catch (const std::exception&) {
+            throw GradeSchemeException(where + ": weights must be numbers");
+        }
+        float total = 0.0f;
+        for (float weight : w) {
+            if (weight < 0.0f || weight > 1.0f)
+                throw GradeSchemeException(where + ": weights must be between 0 and 1");
+            total += weight;
+        }
+        if (std::fabs(total - 1.0f) > 1e-4f)
+            throw GradeSchemeException(where + ": weights must add up to 1");
+
+        if (std::find(names.begin(), names.end(), name) == names.end()) {
+            names.push_back(name);
+        }
+        rules[name].push_back({match, GradeWeights(w[0], w[1], w[2], w[3])});
+    }
+
+    weights.assign(1, GradeWeights());
+    schemes.clear();
+    for (const auto& name : names) {
+        CompiledScheme scheme;
+        scheme.name = name;
+        compile(scheme, rules[name]);
+        schemes.push_back(std::move(scheme));
+    }
+    std::cout << "Loaded " << schemes.size() << " grading schemes from " << filename << std::endl;
+}
+
+// True until a config adds rules; callers can then use the Course cache
+bool GradeEngine::usesBuiltInFormula() const {
+    return weights.size() == 1;
+}
+
+size_t GradeEngine::getSchemeCount() const {
+    return schemes.size();
+}
+
+const std::string& GradeEngine::getSchemeName(size_t scheme) const {
+    return schemes[scheme].name;
+}
+
+float GradeEngine::evaluate(const GradeWeights& w, const Course& course) {
+    float finalGrade;
+    if (w.groupedTests) {
+        // Same operation order as Course::calculateFinalGrade
+        float testTotal = (course.getTest1() + course.getTest2() + course.getTest3()) * w.test1;
+        float examPortion = course.getFinalExam() * w.finalExam;
+        finalGrade = testTotal + examPortion;
+    } else {
+        finalGrade = course.getTest1() * w.test1 + course.getTest2() * w.test2
+                   + course.getTest3() * w.test3 + course.getFinalExam() * w.finalExam;
+    }
+
+    finalGrade = static_cast<int>(finalGrade * 100) / 100.0f;
+    return finalGrade;
+}
+
+float GradeEngine::calculateFinalGrade(const Course& course, size_t scheme) const {
+    return evaluate(weights[ruleFor(schemes[scheme], course.getCourseCode())], course);
+}
+
+size_t GradeEngine::evaluateAll(const std::map<std::string, Student>& students, std::vector<float>& grades) const {
+    size_t schemeCount = schemes.size();
+    size_t rows = 0;
+    for (const auto& [id, student] : students) {
+        rows += student.getCourseCount();
+    }
+    grades.resize(rows * schemeCount);
+
+    size_t row = 0;
+    for (const auto& [id, student] : students) {
+        for (const auto& course : student.getCourses()) {
+            float* out = &grades[row * schemeCount];
+            for (size_t s = 0; s < schemeCount; ++s) {
+                out[s] = evaluate(weights[ruleFor(schemes[s], course.getCourseCode())], course);
+            }
+            row++;
+        }
+    }
+    return rows;
+}
@@ -0,0 +1,68 @@
+#ifndef GRADEENGINE_H
+#define GRADEENGINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include "student.h"
+
+// Weights for one grading rule: finalGrade = t1*w1 + t2*w2 + t3*w3 + exam*wExam
+struct GradeWeights {
+    float test1, test2, test3, finalExam;
+    bool groupedTests;   // all test weights equal, evaluated as (t1+t2+t3)*w
+
+    GradeWeights();
+    GradeWeights(float t1, float t2, float t3, float exam);
+};
+
+// Grading schemes loaded from a config file and compiled into lookup tables.
+//
+// Config lines:   scheme, match, test1, test2, test3, exam
+//   scheme  name of the scheme; "default" is used for Output.txt, any other
+//           name is an alternative evaluated for what-if reports
+//   match   "*", a course-code prefix ("CP", "CP3") or a full code ("CP317");
+//           the longest matching rule wins
+// Blank lines and lines starting with '#' are ignored. Codes with no matching
+// rule use the built-in formula (Test1+Test2+Test3)*20% + FinalExam*40%.
+class GradeEngine {
+    private:
+        // Rule index per course code: one entry per letter pair, expanded to a
+        // 1000-entry digit table only for prefixes with digit-level rules
+        struct CompiledScheme {
+            std::string name;
+            std::vector<uint16_t> pairRule;
+            std::vector<std::unique_ptr<std::vector<uint16_t>>> digitRules;
+        };
+
+        struct Rule {
+            std::string match;
+            GradeWeights weights;
+        };
+
+        std::vector<GradeWeights> weights;     // index 0 is the built-in formula
+        std::vector<CompiledScheme> schemes;   // index 0 is "default"
+
+        static int letterIndex(char c);
+        uint16_t ruleFor(const CompiledScheme& scheme, const std::string& code) const;
+        void compile(CompiledScheme& scheme, std::vector<Rule> rules);
+
+    public:
+        GradeEngine();
+
+        void loadConfig(const std::string& filename);
+
+        bool usesBuiltInFormula() const;
+        size_t getSchemeCount() const;
+        const std::string& getSchemeName(size_t scheme) const;
+
+        // Same truncation as Course::calculateFinalGrade; bit-exact for the built-in rule
+        float calculateFinalGrade(const Course& course, size_t scheme = 0) const;
+        static float evaluate(const GradeWeights& weights, const Course& course);
+
+        // Single pass over all courses in Output.txt order; grades[row * schemeCount + scheme]
+        size_t evaluateAll(const std::map<std::string, Student>& students, std::vector<float>& grades) const;
+};
+
+#endif
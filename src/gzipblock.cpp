@@ -0,0 +1,34 @@
+#include "gzipblock.h"
+#include "exceptions.h"
+#include <climits>
+#include <zlib.h>
+
+// 15 bits of window, plus 16 for a gzip header and trailer instead of zlib's
+static const int GZIP_WINDOW_BITS = 15 + 16;
+static const int GZIP_MEMORY_LEVEL = 8;
+
+void appendGzipMember(const char* data, size_t size, int level, std::string& member) {
+    if (size > UINT_MAX) {
+        throw CompressionException("a block of " + std::to_string(size) + " bytes is too large for one member");
+    }
+    z_stream stream = z_stream();
+    if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, GZIP_MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw CompressionException("cannot start deflate at level " + std::to_string(level));
+    }
+
+    // deflateBound covers the whole member, header and trailer included, so one call finishes it
+    size_t start = member.size();
+    member.resize(start + deflateBound(&stream, static_cast<uLong>(size)));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = reinterpret_cast<Bytef*>(&member[start]);
+    stream.avail_out = static_cast<uInt>(member.size() - start);
+    int status = deflate(&stream, Z_FINISH);
+    size_t written = stream.total_out;
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        member.resize(start);
+        throw CompressionException("deflate could not finish a block");
+    }
+    member.resize(start + written);
+}
@@ -0,0 +1,20 @@
+#ifndef GZIPBLOCK_H
+#define GZIPBLOCK_H
+
+#include <string>
+
+// Compressed Output.txt is a multi-member gzip stream, as pigz writes it:
+// the rows are cut into blocks, each block is deflated on its own into a
+// complete gzip member, and the members are written in order. gzip, zcat
+// and zlib read concatenated members as one stream, so the file
+// decompresses to exactly the bytes the plain writer produces.
+
+const int GZIP_MIN_LEVEL = 0;          // stored, no compression
+const int GZIP_DEFAULT_LEVEL = 6;       // gzip's own default
+const int GZIP_MAX_LEVEL = 9;
+
+// Deflates one block into a complete gzip member appended to member;
+// throws CompressionException
+void appendGzipMember(const char* data, size_t size, int level, std::string& member);
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef INLINEVECTOR_H
+#define INLINEVECTOR_H
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+
+// Fixed-capacity sequence stored inside the owning object; never touches the
+// heap. Supports the subset of std::vector that Student uses.
+template <typename T, size_t Capacity>
+class InlineVector {
+    private:
+        alignas(T) unsigned char storage[Capacity * sizeof(T)];
+        size_t count;
+
+        // Where slot index is, live or not; for placement new and end()
+        T* address(size_t index) {
+            return reinterpret_cast<T*>(storage) + index;
+        }
+
+        const T* address(size_t index) const {
+            return reinterpret_cast<const T*>(storage) + index;
+        }
+
+        // Only for slots below count, where an object lives
+        T* element(size_t index) {
+            return std::launder(address(index));
+        }
+
+        const T* element(size_t index) const {
+            return std::launder(address(index));
+        }
+
+    public:
+        typedef T value_type;
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
+        InlineVector() : count(0) {}
+
+        InlineVector(const InlineVector& other) : count(0) {
+            for (const T& item : other) {
+                push_back(item);
+            }
+        }
+
+        InlineVector(InlineVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) : count(0) {
+            for (T& item : other) {
+                push_back(std::move(item));
+            }
+            other.clear();
+        }
+
+        InlineVector& operator=(const InlineVector& other) {
+            if (this != &other) {
+                clear();
+                for (const T& item : other) {
+                    push_back(item);
+                }
+            }
+            return *this;
+        }
+
+        InlineVector& operator=(InlineVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            if (this != &other) {
+                clear();
+                for (T& item : other) {
+                    push_back(std::move(item));
+                }
+                other.clear();
+            }
+            return *this;
+        }
+
+        ~InlineVector() {
+            clear();
+        }
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        bool full() const { return count == Capacity; }
+        static constexpr size_t capacity() { return Capacity; }
+
+        iterator begin() { return count > 0 ? element(0) : address(0); }
+        iterator end() { return address(count); }
+        const_iterator begin() const { return count > 0 ? element(0) : address(0); }
+        const_iterator end() const { return address(count); }
+
+        T& operator[](size_t index) { return *element(index); }
+        const T& operator[](size_t index) const { return *element(index); }
+
+        // Callers check full() first; overflowing is a programming error
+        void push_back(const T& item) {
+            if (full()) {
+                throw std::length_error("InlineVector capacity exceeded");
+            }
+            new (address(count)) T(item);
+            count++;
+        }
+
+        void push_back(T&& item) {
+            if (full()) {
+                throw std::length_error("InlineVector capacity exceeded");
+            }
+            new (address(count)) T(std::move(item));
+            count++;
+        }
+
+        // Shifts the tail down by one, like std::vector::erase
+        iterator erase(iterator position) {
+            for (iterator it = position; it + 1 != end(); ++it) {
+                *it = std::move(*(it + 1));
+            }
+            element(count - 1)->~T();
+            count--;
+            return position;
+        }
+
+        void clear() {
+            while (count > 0) {
+                element(count - 1)->~T();
+                count--;
+            }
+        }
+};
+
+#endif
@@ -3,60 +3,516 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <memory>
+#include <future>
+#include <thread>
 #include "student.h"
 #include "course.h"
 #include "exceptions.h"
 #include "filereader.h"
 #include "filewriter.h"
+#include "gradeengine.h"
+#include "transcriptwriter.h"
+#include "bloomfilter.h"
+#include "dataset.h"
+#include "mergejoin.h"
+#include "samplepreview.h"
+#include "coordinator.h"
+#include "correctionlog.h"
+#include "outputmanifest.h"
+#include "outputsnapshot.h"
+#include "nameindex.h"
+#include "shareddataset.h"
+#include "rowindex.h"
+#include "memoryaccount.h"
+#include "stageprofiler.h"
+#include "checkpoint.h"
+#include "ranking.h"
+#include "gzipblock.h"
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Optional modes selected on the command line
+struct RunOptions {
+    std::string columnarPath;
+    unsigned writerThreads = 1;
+    std::string schemesPath;
+    std::string whatIfPath;
+    std::string transcriptDirectory;
+    std::string transcriptArchive;
+    double bloomFalsePositiveRate = 0.0;
+    std::string datasetRoot;
+    std::string datasetOutputPath = "../DatasetOutput.txt";
+    DatasetQuery datasetQuery;
+    bool concurrentLoad = false;
+    bool streaming = false;
+    bool bulkValidate = false;
+    size_t previewRows = 0;
+    std::string inputDirectory = "..";
+    std::string outputPath = "../Output.txt";
+    unsigned workerProcesses = 0;
+    bool worker = false;
+    std::string correctionLogPath;
+    std::string nameQuery;
+    std::string sharedPublish;
+    std::string sharedAttach;
+    std::string sharedUnlink;
+    std::vector<std::string> lookupIDs;
+    size_t memoryBudgetMB = 0;
+    bool profile = false;
+    std::string checkpointPath;
+    size_t checkpointRows = 1000000;
+    bool rank = false;
+    size_t topCount = 0;
+    int gzipLevel = -1;                 // below GZIP_MIN_LEVEL: plain text
+};
+
+// Rows sampled from each input to project a load against the memory budget
+static const size_t MEMORY_SAMPLE_ROWS = 2000;
+
+// --threads limit when the hardware thread count is unknown
+static const unsigned MAX_THREADS = 64;
 
 // Function prototypes
 std::vector<std::string> split(const std::string& str, char delimiter);
 std::string trim(const std::string& str);
+bool parseOptions(int argc, char* argv[], RunOptions& options);
+int runDatasetMode(const RunOptions& options);
+int runPreviewMode(const RunOptions& options);
+int runCoordinatorMode(const RunOptions& options, const char* argv0);
+int runSharedMode(const RunOptions& options);
+int runLookupMode(const RunOptions& options);
+int runCorrectionPatch(const RunOptions& options, OutputManifest& manifest, OutputSnapshot& snapshot,
+                       const std::string& outputPath);
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "=== CP317 Data Analysis Project ===" << std::endl;
+
+    RunOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    if (!options.datasetRoot.empty()) {
+        return runDatasetMode(options);
+    }
+
+    if (options.previewRows > 0) {
+        return runPreviewMode(options);
+    }
+
+    if (!options.lookupIDs.empty()) {
+        return runLookupMode(options);
+    }
+
+    if (!options.sharedAttach.empty() || !options.sharedUnlink.empty()) {
+        return runSharedMode(options);
+    }
+
+    if (options.workerProcesses > 0) {
+        return runCoordinatorMode(options, argv[0]);
+    }
+
+    const std::string nameFilePath = options.inputDirectory + "/NameFile.txt";
+    const std::string courseFilePath = options.inputDirectory + "/CourseFile.txt";
+
+    // Streaming only produces Output.txt; the other outputs need the full map
+    bool needsStudentMap = !options.columnarPath.empty() || !options.whatIfPath.empty()
+                        || !options.transcriptDirectory.empty() || !options.transcriptArchive.empty()
+                        || !options.correctionLogPath.empty() || !options.nameQuery.empty()
+                        || !options.sharedPublish.empty()
+                        || options.rank || options.topCount > 0 || options.gzipLevel >= GZIP_MIN_LEVEL;
+    // The row filter can replay students after the load, so it needs the map too
+    bool filterRows = options.datasetQuery.filtersRows();
+    // Checkpoints snapshot the map, but not the row filter's replay state
+    bool checkpointing = !options.checkpointPath.empty() && !filterRows;
+    if (!options.checkpointPath.empty() && filterRows) {
+        std::cout << "Note: --checkpoint ignored with --course-filter or --id-range" << std::endl;
+    }
+    needsStudentMap = needsStudentMap || filterRows || checkpointing;
+    if (options.streaming && needsStudentMap) {
+        std::cout << "Note: --streaming ignored, the requested outputs need all students in memory" << std::endl;
+    }
+    bool streaming = options.streaming && !needsStudentMap;
+
+    // Compressed output goes next to Output.txt as "<output>.gz", never over the plain file
+    std::string outputPath = options.outputPath;
+    bool compressOutput = options.gzipLevel >= GZIP_MIN_LEVEL;
+    if (compressOutput && (outputPath.size() < 3 || outputPath.compare(outputPath.size() - 3, 3, ".gz") != 0)) {
+        outputPath += ".gz";
+    }
+
+    // What shapes Output.txt, so a later corrections run can tell whether its snapshot still holds
+    OutputManifest manifest(outputPath);
+    manifest.addInput("names", nameFilePath);
+    manifest.addInput("courses", courseFilePath);
+    manifest.addInput("schemes", options.schemesPath);
+    std::string courseCodes;
+    for (const auto& code : options.datasetQuery.courseCodes) {
+        courseCodes += (courseCodes.empty() ? "" : ",") + code;
+    }
+    manifest.addSetting("course-filter", courseCodes);
+    manifest.addSetting("id-range", options.datasetQuery.minStudentID + "-" + options.datasetQuery.maxStudentID);
+    manifest.addSetting("format", compressOutput ? "gzip" : options.rank ? "ranked" : "plain");
+
+    // --corrections: while the manifest matches, the students come from the snapshot of the
+    // last corrections run instead of the inputs. When Output.txt is the only output and no row
+    // depends on another, only the corrected students are read and their rows patched in place
+    OutputSnapshot snapshot(manifest.getSnapshotName());
+    bool fromSnapshot = false;
+    if (!options.correctionLogPath.empty()) {
+        fromSnapshot = manifest.matches();
+        bool otherOutputs = !options.columnarPath.empty() || !options.whatIfPath.empty()
+                         || !options.transcriptDirectory.empty() || !options.transcriptArchive.empty()
+                         || !options.nameQuery.empty() || !options.sharedPublish.empty() || options.topCount > 0;
+        // A correction can move every student's rank, and compressed output cannot be patched row by row
+        if (fromSnapshot && !otherOutputs && !options.rank && !compressOutput) {
+            return runCorrectionPatch(options, manifest, snapshot, outputPath);
+        }
+        if (!fromSnapshot && std::ifstream(outputPath).peek() != std::char_traits<char>::eof()) {
+            std::cout << "Note: " << outputPath << " was not written from these inputs and settings, "
+                      << "rewriting it in full" << std::endl;
+        }
+    }
+    checkpointing = checkpointing && !fromSnapshot;
+    bool stageCourses = (options.concurrentLoad || options.bulkValidate)
+                     && !streaming && !filterRows && !checkpointing && !fromSnapshot;
+
+    // With a budget, project the load from a sample of the inputs and fall back
+    // to a leaner strategy, or stop, before anything is read in full
+    MemoryAccount memory(options.memoryBudgetMB * 1024 * 1024);
+    bool overBudget = false;
+    if (memory.getBudget() > 0 && !streaming && !fromSnapshot) {
+        try {
+            SamplePreview sample(MEMORY_SAMPLE_ROWS);
+            if (sample.run(nameFilePath, courseFilePath)) {
+                MemoryFootprint projected = MemoryAccount::projectLoad(sample, stageCourses);
+                std::cout << "Projected memory: " << MemoryAccount::formatMegabytes(projected.total()) << " MB of "
+                          << MemoryAccount::formatMegabytes(memory.getBudget()) << " MB budget" << std::endl;
+                if (!memory.fitsBudget(projected) && stageCourses
+                    && memory.fitsBudget(MemoryAccount::projectLoad(sample, false))) {
+                    std::cout << "Note: staging CourseFile.txt would exceed the memory budget, reading it row by row" << std::endl;
+                    stageCourses = false;
+                } else if (!memory.fitsBudget(projected) && !needsStudentMap) {
+                    std::cout << "Note: loading would exceed the memory budget, streaming instead" << std::endl;
+                    streaming = true;
+                    stageCourses = false;
+                    overBudget = true;
+                } else if (!memory.fitsBudget(projected)) {
+                    throw MemoryBudgetException("loading " + nameFilePath + " and " + courseFilePath + " needs about "
+                                                + MemoryAccount::formatMegabytes(projected.total()) + " MB, over the "
+                                                + MemoryAccount::formatMegabytes(memory.getBudget()) + " MB budget;"
+                                                " raise --memory-budget or drop the outputs that need every student"
+                                                " in memory");
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     std::cout << "Reading student data files..." << std::endl;
     
     // Map to store students by ID for quick lookup
     std::map<std::string, Student> students;
     
+    // With --concurrent-load, CourseFile.txt is parsed into a staging buffer on
+    // a second thread while NameFile.txt loads; the future joins on every path.
+    // --bulk-validate also stages, then validates the staged rows as columns.
+    std::vector<CourseRecord> stagedCourses;
+    std::future<bool> courseStaging;
+    // --profile: hardware counters per pipeline stage, reported per row. Opened before
+    // the stager starts, so its thread is counted in when it exits
+    std::unique_ptr<StageProfiler> profiler;
+    if (options.profile) {
+        profiler.reset(new StageProfiler());
+    }
+
+    if (stageCourses) {
+        auto policy = options.concurrentLoad ? std::launch::async : std::launch::deferred;
+        bool bulkValidate = options.bulkValidate;
+        courseStaging = std::async(policy, [&stagedCourses, bulkValidate, courseFilePath]() {
+            FileReader stager;
+            stager.setFileName(courseFilePath);
+            if (!stager.stageCourseFile(stagedCourses)) {
+                return false;
+            }
+            if (bulkValidate) {
+                FileReader::validateCourseRecords(stagedCourses);
+            }
+            return true;
+        });
+    }
+
     try {
-        // Read NameFile.txt
-        std::cout << "Reading NameFile.txt..." << std::endl;
-        FileReader nameFile ("../NameFile.txt");
-        if (!nameFile.readNameFile(students)){
-            std::cerr << "Error: Failed to read " << nameFile.getFileName() <<std::endl;
-            return 1;
+        // Grading schemes; the built-in formula unless a config is given
+        GradeEngine gradeEngine;
+        if (!options.schemesPath.empty()) {
+            gradeEngine.loadConfig(options.schemesPath);
         }
-        std::cout << "Successfully read " << students.size() << " students" << std::endl;
-        
-        // Read CourseFile.txt and add courses to students
-        std::cout << "Reading CourseFile.txt..." << std::endl;
-        FileReader courseFile ("../CourseFile.txt");
-        if (!courseFile.readCourseFile(students)) {
-            std::cerr << "Error: Failed to read " << courseFile.getFileName()<<std::endl;
-            return 1;
+
+        // Pre-sorted inputs: merge-join both files straight into Output.txt
+        if (streaming) {
+            try {
+                std::cout << "Streaming sorted NameFile.txt and CourseFile.txt..." << std::endl;
+                FileReader nameFile (nameFilePath);
+                FileReader courseFile (courseFilePath);
+                FileWriter outputFile (options.outputPath);
+                outputFile.setGradeEngine(&gradeEngine);
+                StreamingJoin join(nameFile, courseFile, outputFile);
+                if (profiler) profiler->begin("streaming join");
+                bool joined = join.run();
+                if (profiler) profiler->end(join.getStudentsRead());
+                if (!joined) {
+                    std::cerr << "Error: No course records written to " << outputFile.getFileName() << std::endl;
+                    return 1;
+                }
+                std::cout << "✓ Successfully generated Output.txt" << std::endl;
+                if (profiler) {
+                    profiler->printReport();
+                }
+                std::cout << "Processing complete!" << std::endl;
+                return 0;
+            } catch (const UnsortedInputException& e) {
+                if (overBudget) {
+                    throw MemoryBudgetException("the inputs are not sorted by student ID, so they cannot be streamed,"
+                                                " and loading them would exceed the budget; sort both files by"
+                                                " student ID or raise --memory-budget");
+                }
+                std::cerr << "Warning: " << e.what() << std::endl;
+                std::cerr << "Warning: Falling back to in-memory processing" << std::endl;
+            }
         }
-        
-        // Count total courses
+
+        std::unique_ptr<Checkpoint> checkpoint;
         int totalCourses = 0;
-        for (const auto& [id, student] : students) {
-            totalCourses += student.getCourseCount();
+        if (fromSnapshot) {
+            // Corrected on top of the last corrections run, without parsing either input
+            std::cout << "Reading " << snapshot.getPath() << "..." << std::endl;
+            if (!snapshot.loadAll(students)) {
+                std::cerr << "Error: Failed to read " << snapshot.getPath() << std::endl;
+                return 1;
+            }
+            for (const auto& [id, student] : students) {
+                totalCourses += student.getCourseCount();
+            }
+            std::cout << "Successfully read " << students.size() << " students and " << totalCourses
+                      << " course records" << std::endl;
+        } else {
+            // --checkpoint: pick up from the last snapshot of these inputs, if there is one
+            if (checkpointing) {
+                checkpoint.reset(new Checkpoint(options.checkpointPath, nameFilePath, courseFilePath, options.checkpointRows));
+                if (checkpoint->load(students)) {
+                    std::cout << "Resuming from checkpoint " << checkpoint->getPath() << ": " << students.size()
+                              << " students, " << (checkpoint->getStage() == CHECKPOINT_NAMES ? "NameFile.txt" : "CourseFile.txt")
+                              << " from line " << checkpoint->getLineNumber() + 1 << std::endl;
+                }
+            }
+
+            // Read NameFile.txt
+            std::cout << "Reading NameFile.txt..." << std::endl;
+            FileReader nameFile (nameFilePath);
+            if (filterRows) nameFile.setRowFilter(&options.datasetQuery);
+            nameFile.setCheckpoint(checkpoint.get());
+            if (profiler) profiler->begin("name ingest");
+            bool namesRead = nameFile.readNameFile(students);
+            if (profiler) profiler->end(students.size());
+            // A worker's shard may legitimately hold no usable rows
+            if (!namesRead && !options.worker){
+                std::cerr << "Error: Failed to read " << nameFile.getFileName() <<std::endl;
+                return 1;
+            }
+            std::cout << "Successfully read " << students.size() << " students" << std::endl;
+
+            // Course slots are inside each Student, so this is nearly the whole load. Rows staged
+            // meanwhile count too, so with a budget wait for the stager before measuring them
+            memory.measureStudents(students);
+            memory.measureStreams(2);
+            if (memory.getBudget() > 0 && courseStaging.valid()) {
+                courseStaging.wait();
+                memory.measureStagedCourses(stagedCourses);
+            }
+            memory.checkBudget("NameFile.txt");
+        
+            // Read CourseFile.txt and add courses to students
+            std::cout << "Reading CourseFile.txt..." << std::endl;
+            FileReader courseFile (courseFilePath);
+            if (filterRows) courseFile.setRowFilter(&options.datasetQuery);
+            courseFile.setCheckpoint(checkpoint.get());
+
+            // Optional prefilter for course rows that name unknown students
+            std::unique_ptr<BloomFilter> studentFilter;
+            if (options.bloomFalsePositiveRate > 0.0) {
+                studentFilter.reset(new BloomFilter(students.size(), options.bloomFalsePositiveRate));
+                for (const auto& [id, student] : students) {
+                    studentFilter->add(id);
+                }
+                courseFile.setStudentFilter(studentFilter.get());
+            }
+            // One stage however the rows arrive: staging (on this thread when deferred), the join,
+            // or reading row by row
+            if (profiler) profiler->begin("course ingest");
+            bool staged = courseStaging.valid() && courseStaging.get();
+            bool coursesRead = staged ? courseFile.joinCourseRecords(stagedCourses, students)
+                                      : courseFile.readCourseFile(students);
+            if (!coursesRead && !options.worker) {
+                std::cerr << "Error: Failed to read " << courseFile.getFileName()<<std::endl;
+                return 1;
+            }
+        
+            // Count total courses
+            for (const auto& [id, student] : students) {
+                totalCourses += student.getCourseCount();
+            }
+            if (profiler) profiler->end(totalCourses);
+            std::cout << "Successfully processed " << totalCourses << " course records" << std::endl;
+
+            // The staged rows are no longer needed; account for them at their peak, then free them
+            memory.measureStudents(students);
+            memory.measureStagedCourses(stagedCourses);
+            memory.checkBudget("CourseFile.txt");
+            std::vector<CourseRecord>().swap(stagedCourses);
+        }
+
+        // Grade corrections, on top of the earlier ones when the students came from the snapshot
+        if (!options.correctionLogPath.empty()) {
+            std::cout << "Applying corrections from " << options.correctionLogPath << "..." << std::endl;
+            CorrectionLog corrections;
+            if (!corrections.readLogFile(options.correctionLogPath)) {
+                std::cerr << "Error: Failed to read " << options.correctionLogPath << std::endl;
+                return 1;
+            }
+            corrections.apply(students);
         }
-        std::cout << "Successfully processed " << totalCourses << " course records" << std::endl;
         
+        // --rank: cohort and per-course ranks as extra Output.txt columns
+        std::unique_ptr<Ranking> ranking;
+        if (options.rank) {
+            if (profiler) profiler->begin("ranking");
+            ranking.reset(new Ranking(students, options.writerThreads, &gradeEngine));
+            if (profiler) profiler->end(students.size());
+        }
+
         // Write output file
         std::cout << "Writing Output.txt..." << std::endl;
-        FileWriter outputFile ("../Output.txt");
-        if (!outputFile.writeOutputFile(students)) {
-            std::cerr << "Error: Failed to write " << outputFile.getFileName() <<std::endl;
+        if (profiler) profiler->begin("output writing");
+        bool written;
+        if (compressOutput) {
+            // A new file, so unlike Output.txt it need not exist beforehand
+            FileWriter outputFile;
+            outputFile.setFileName(outputPath);
+            outputFile.setGradeEngine(&gradeEngine);
+            outputFile.setRanking(ranking.get());
+            written = outputFile.writeCompressedOutputFile(students, options.gzipLevel, options.writerThreads);
+        } else {
+            FileWriter outputFile (outputPath);
+            outputFile.setGradeEngine(&gradeEngine);
+            outputFile.setRanking(ranking.get());
+            written = options.writerThreads > 1 ? outputFile.writeOutputFileParallel(students, options.writerThreads)
+                                                : outputFile.writeOutputFile(students);
+        }
+        if (profiler) profiler->end(totalCourses);
+        if (!written) {
+            std::cerr << "Error: Failed to write " << outputPath <<std::endl;
             return 1;
         }
         
         std::cout << "✓ Successfully generated Output.txt" << std::endl;
+
+        // The next corrections run starts from these students; plain rows are indexed for patching
+        if (!options.correctionLogPath.empty()) {
+            if (!snapshot.save(students, compressOutput || options.rank ? "" : outputPath)) {
+                std::cerr << "Warning: Failed to write " << snapshot.getPath()
+                          << ", the next corrections run reloads the inputs" << std::endl;
+                manifest.remove();
+            } else if (!manifest.save()) {
+                std::cerr << "Warning: Failed to write " << manifest.getManifestName() << std::endl;
+            }
+        }
+
+        if (!options.columnarPath.empty()) {
+            std::cout << "Writing " << options.columnarPath << "..." << std::endl;
+            FileWriter columnarFile;
+            columnarFile.setFileName(options.columnarPath);
+            columnarFile.setGradeEngine(&gradeEngine);
+            if (!columnarFile.writeColumnarFile(students)) {
+                std::cerr << "Error: Failed to write " << columnarFile.getFileName() << std::endl;
+                return 1;
+            }
+        }
+
+        if (!options.whatIfPath.empty()) {
+            std::cout << "Writing " << options.whatIfPath << "..." << std::endl;
+            FileWriter whatIfFile;
+            whatIfFile.setFileName(options.whatIfPath);
+            whatIfFile.setGradeEngine(&gradeEngine);
+            if (!whatIfFile.writeWhatIfFile(students)) {
+                std::cerr << "Error: Failed to write " << whatIfFile.getFileName() << std::endl;
+                return 1;
+            }
+        }
+
+        if (!options.transcriptDirectory.empty() || !options.transcriptArchive.empty()) {
+            std::cout << "Writing transcripts..." << std::endl;
+            TranscriptWriter transcripts(options.writerThreads);
+            if (!options.transcriptDirectory.empty() && !transcripts.writeDirectory(students, options.transcriptDirectory)) {
+                std::cerr << "Error: Failed to write transcripts to " << options.transcriptDirectory << std::endl;
+                return 1;
+            }
+            if (!options.transcriptArchive.empty() && !transcripts.writeArchive(students, options.transcriptArchive)) {
+                std::cerr << "Error: Failed to write " << options.transcriptArchive << std::endl;
+                return 1;
+            }
+        }
+
+        if (!options.sharedPublish.empty()) {
+            uint64_t generation = publishSharedDataset(options.sharedPublish, students);
+            std::cout << "Published generation " << generation << " of " << options.sharedPublish
+                      << " (" << students.size() << " students)" << std::endl;
+        }
+
+        if (options.topCount > 0) {
+            std::vector<RankedStudent> best = Ranking::top(students, options.topCount, &gradeEngine);
+            std::cout << "Top " << best.size() << " of " << students.size() << " students by overall average:" << std::endl;
+            for (const auto& entry : best) {
+                std::ostringstream line;
+                line << std::fixed << std::setprecision(1) << "  " << entry.rank.rank << ". "
+                     << entry.student->getStudentID() << ", " << entry.student->getStudentName() << ", "
+                     << entry.average << " (percentile " << entry.rank.percentile << ")";
+                std::cout << line.str() << std::endl;
+            }
+        }
+
+        if (!options.nameQuery.empty()) {
+            NameIndex names(students);
+            std::cout << "Name index: " << names.getNameCount() << " students, "
+                      << names.getDistinctNameCount() << " distinct names" << std::endl;
+            auto printMatches = [&students](const std::string& heading, const std::vector<std::string>& ids) {
+                std::cout << heading << " (" << ids.size() << "):" << std::endl;
+                for (size_t i = 0; i < ids.size() && i < 20; ++i) {
+                    std::cout << "  " << ids[i] << ", " << students.at(ids[i]).getStudentName() << std::endl;
+                }
+            };
+            printMatches("Names starting with \"" + options.nameQuery + "\"", names.findPrefix(options.nameQuery));
+            printMatches("Names within one edit of \"" + options.nameQuery + "\"", names.findSimilar(options.nameQuery));
+        }
+
+        // Every output is written, so the next run starts from the beginning
+        if (checkpoint) checkpoint->discard();
+
+        memory.printReport();
+        if (profiler) {
+            profiler->printReport();
+        }
+        std::cout << "Grade cache: " << Course::getCacheHits() << " hits, " << Course::getCacheMisses()
+                  << " misses (final grades); " << Student::getCacheHits() << " hits, "
+                  << Student::getCacheMisses() << " misses (averages)" << std::endl;
         std::cout << "Processing complete!" << std::endl;
         
     } catch (const std::exception& e) {
@@ -67,6 +523,362 @@ int main() {
     return 0;
 }
 
+// Multi-term report: prune partitions by metadata, load the rest in parallel
+int runDatasetMode(const RunOptions& options) {
+    try {
+        Dataset dataset(options.datasetRoot);
+        std::vector<TermPartition> partitions = dataset.load(options.datasetQuery, options.writerThreads);
+
+        FileWriter outputFile;
+        outputFile.setFileName(options.datasetOutputPath);
+        if (!outputFile.writeDatasetFile(partitions, options.datasetQuery)) {
+            std::cerr << "Error: Failed to write " << outputFile.getFileName() << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Approximate report from a sample of each input file
+int runPreviewMode(const RunOptions& options) {
+    try {
+        std::cout << "Sampling " << options.previewRows << " rows per file..." << std::endl;
+        SamplePreview preview(options.previewRows);
+        if (!preview.run(options.inputDirectory + "/NameFile.txt", options.inputDirectory + "/CourseFile.txt")) {
+            std::cerr << "Error: Failed to sample input files" << std::endl;
+            return 1;
+        }
+        preview.printReport();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Scatter/gather: shard the input by student ID, run this binary as a
+// worker per shard, then merge the sorted partial outputs
+int runCoordinatorMode(const RunOptions& options, const char* argv0) {
+    std::string executable = argv0;
+#ifndef _WIN32
+    char self[4096];
+    ssize_t length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (length > 0) {
+        executable.assign(self, length);
+    }
+#endif
+    // Options that hold per student carry over to the workers, since each student's
+    // rows all land in one shard; the rest need every student in one process
+    std::vector<std::string> ignored;
+    if (options.gzipLevel >= GZIP_MIN_LEVEL) ignored.push_back("--gzip");
+    if (options.rank) ignored.push_back("--rank");
+    if (options.topCount > 0) ignored.push_back("--top");
+    if (!options.correctionLogPath.empty()) ignored.push_back("--corrections");
+    if (!options.checkpointPath.empty()) ignored.push_back("--checkpoint");
+    if (options.memoryBudgetMB > 0) ignored.push_back("--memory-budget");
+    if (options.profile) ignored.push_back("--profile");
+    if (!options.columnarPath.empty()) ignored.push_back("--columnar");
+    if (!options.whatIfPath.empty()) ignored.push_back("--what-if");
+    if (!options.transcriptDirectory.empty()) ignored.push_back("--transcripts");
+    if (!options.transcriptArchive.empty()) ignored.push_back("--transcript-archive");
+    if (!options.nameQuery.empty()) ignored.push_back("--find-name");
+    if (!options.sharedPublish.empty()) ignored.push_back("--shm-publish");
+    if (!ignored.empty()) {
+        std::string list;
+        for (const auto& option : ignored) {
+            list += (list.empty() ? "" : ", ") + option;
+        }
+        std::cout << "Note: " << list << " ignored with --workers" << std::endl;
+    }
+
+    try {
+        Coordinator coordinator(options.workerProcesses, executable);
+        coordinator.setSchemesPath(options.schemesPath);
+        if (options.writerThreads > 1) coordinator.addWorkerOption("--threads", std::to_string(options.writerThreads));
+        if (options.streaming) coordinator.addWorkerOption("--streaming");
+        if (options.concurrentLoad) coordinator.addWorkerOption("--concurrent-load");
+        if (options.bulkValidate) coordinator.addWorkerOption("--bulk-validate");
+        if (options.bloomFalsePositiveRate > 0.0) {
+            std::ostringstream rate;
+            rate << options.bloomFalsePositiveRate;
+            coordinator.addWorkerOption("--bloom-fpr", rate.str());
+        }
+        if (!options.datasetQuery.courseCodes.empty()) {
+            std::string codes;
+            for (const auto& code : options.datasetQuery.courseCodes) {
+                codes += (codes.empty() ? "" : ",") + code;
+            }
+            coordinator.addWorkerOption("--course-filter", codes);
+        }
+        if (!options.datasetQuery.minStudentID.empty() || !options.datasetQuery.maxStudentID.empty()) {
+            coordinator.addWorkerOption("--id-range", options.datasetQuery.minStudentID + "-" + options.datasetQuery.maxStudentID);
+        }
+        if (!coordinator.run(options.inputDirectory + "/NameFile.txt", options.inputDirectory + "/CourseFile.txt",
+                             options.outputPath)) {
+            std::cerr << "Error: Failed to write " << options.outputPath << std::endl;
+            return 1;
+        }
+        std::cout << "✓ Successfully generated Output.txt" << std::endl;
+        std::cout << "Processing complete!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Reports from a dataset another process published; no input files are read
+int runSharedMode(const RunOptions& options) {
+    try {
+        if (!options.sharedUnlink.empty()) {
+            unlinkSharedDataset(options.sharedUnlink);
+            std::cout << "Removed shared dataset " << options.sharedUnlink << std::endl;
+            return 0;
+        }
+
+        SharedDatasetView dataset(options.sharedAttach);
+        std::cout << "Attached to generation " << dataset.getGeneration() << " of " << options.sharedAttach << " ("
+                  << dataset.getStudentCount() << " students, " << dataset.getCourseCount() << " courses, "
+                  << dataset.getSize() << " bytes)" << std::endl;
+
+        GradeEngine gradeEngine;
+        if (!options.schemesPath.empty()) {
+            gradeEngine.loadConfig(options.schemesPath);
+        }
+        FileWriter outputFile (options.outputPath);
+        outputFile.setGradeEngine(&gradeEngine);
+        if (!outputFile.writeSharedOutputFile(dataset)) {
+            std::cerr << "Error: Failed to write " << outputFile.getFileName() << std::endl;
+            return 1;
+        }
+        std::cout << "✓ Successfully generated Output.txt" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Transcripts for a few students, read through the sidecar row indexes
+// instead of loading either input file
+int runLookupMode(const RunOptions& options) {
+    try {
+        const std::string nameFilePath = options.inputDirectory + "/NameFile.txt";
+        const std::string courseFilePath = options.inputDirectory + "/CourseFile.txt";
+        RowIndex nameIndex(nameFilePath);
+        RowIndex courseIndex(courseFilePath);
+        nameIndex.open();
+        courseIndex.open();
+
+        std::map<std::string, Student> students;
+        FileReader nameFile (nameFilePath);
+        Student student;
+        for (const auto& id : options.lookupIDs) {
+            for (const auto& row : nameIndex.find(id)) {
+                nameFile.seekToRow(row.offset, row.lineNumber);
+                if (nameFile.readNextStudent(student) && student.getStudentID() == id) {
+                    students[id] = student;
+                }
+            }
+        }
+
+        FileReader courseFile (courseFilePath);
+        CourseRecord record;
+        for (const auto& id : options.lookupIDs) {
+            for (const auto& row : courseIndex.find(id)) {
+                courseFile.seekToRow(row.offset, row.lineNumber);
+                if (courseFile.readNextCourseRecord(record)) {
+                    courseFile.applyCourseRecord(record, students);
+                }
+            }
+        }
+
+        for (const auto& id : options.lookupIDs) {
+            auto it = students.find(id);
+            if (it == students.end()) {
+                std::cout << "Student ID " << id << " not found in " << nameFilePath << std::endl;
+                continue;
+            }
+            std::string transcript;
+            TranscriptWriter::renderTranscript(it->second, transcript);
+            std::cout << transcript;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// A corrections run against an unchanged Output.txt: reads only the students the log
+// names from the snapshot and rewrites their rows through its row offsets
+int runCorrectionPatch(const RunOptions& options, OutputManifest& manifest, OutputSnapshot& snapshot,
+                       const std::string& outputPath) {
+    try {
+        GradeEngine gradeEngine;
+        if (!options.schemesPath.empty()) {
+            gradeEngine.loadConfig(options.schemesPath);
+        }
+
+        std::cout << "Applying corrections from " << options.correctionLogPath << "..." << std::endl;
+        CorrectionLog corrections;
+        if (!corrections.readLogFile(options.correctionLogPath)) {
+            std::cerr << "Error: Failed to read " << options.correctionLogPath << std::endl;
+            return 1;
+        }
+        std::map<std::string, Student> students;
+        if (!snapshot.loadStudents(corrections.getStudentIDs(), students)) {
+            std::cerr << "Error: Failed to read " << snapshot.getPath() << std::endl;
+            return 1;
+        }
+        std::set<std::string> changed = corrections.apply(students);
+
+        std::cout << "Writing Output.txt..." << std::endl;
+        FileWriter outputFile;
+        outputFile.setFileName(outputPath);
+        outputFile.setGradeEngine(&gradeEngine);
+        if (!outputFile.patchOutputFile(students, changed, snapshot)) {
+            std::cerr << "Error: Failed to write " << outputPath << std::endl;
+            return 1;
+        }
+        std::cout << "✓ Successfully generated Output.txt" << std::endl;
+        if (!manifest.save()) {
+            std::cerr << "Warning: Failed to write " << manifest.getManifestName() << std::endl;
+        }
+        std::cout << "Processing complete!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// POSIX shared-memory names start with a single slash
+static std::string sharedName(const std::string& name) {
+    return name.empty() || name[0] == '/' ? name : "/" + name;
+}
+
+bool parseOptions(int argc, char* argv[], RunOptions& options) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--columnar" && hasValue) {
+                options.columnarPath = argv[++i];
+            } else if (arg == "--schemes" && hasValue) {
+                options.schemesPath = argv[++i];
+            } else if (arg == "--what-if" && hasValue) {
+                options.whatIfPath = argv[++i];
+            } else if (arg == "--transcripts" && hasValue) {
+                options.transcriptDirectory = argv[++i];
+            } else if (arg == "--transcript-archive" && hasValue) {
+                options.transcriptArchive = argv[++i];
+            } else if (arg == "--bloom-fpr" && hasValue) {
+                options.bloomFalsePositiveRate = std::stod(argv[++i]);
+            } else if (arg == "--dataset" && hasValue) {
+                options.datasetRoot = argv[++i];
+            } else if (arg == "--dataset-output" && hasValue) {
+                options.datasetOutputPath = argv[++i];
+            } else if (arg == "--terms" && hasValue) {
+                for (const auto& term : split(argv[++i], ',')) {
+                    options.datasetQuery.terms.insert(trim(term));
+                }
+            } else if (arg == "--course-filter" && hasValue) {
+                for (const auto& code : split(argv[++i], ',')) {
+                    options.datasetQuery.courseCodes.insert(trim(code));
+                }
+            } else if (arg == "--id-range" && hasValue) {
+                std::vector<std::string> range = split(argv[++i], '-');
+                if (range.size() != 2) {
+                    throw std::invalid_argument("--id-range expects <min>-<max>");
+                }
+                options.datasetQuery.minStudentID = trim(range[0]);
+                options.datasetQuery.maxStudentID = trim(range[1]);
+            } else if (arg == "--streaming") {
+                options.streaming = true;
+            } else if (arg == "--bulk-validate") {
+                options.bulkValidate = true;
+            } else if (arg == "--concurrent-load") {
+                options.concurrentLoad = true;
+            } else if (arg == "--preview" && hasValue) {
+                options.previewRows = std::stoul(argv[++i]);
+            } else if (arg == "--workers" && hasValue) {
+                options.workerProcesses = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--worker") {
+                options.worker = true;
+            } else if (arg == "--input-dir" && hasValue) {
+                options.inputDirectory = argv[++i];
+            } else if (arg == "--output" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (arg == "--corrections" && hasValue) {
+                options.correctionLogPath = argv[++i];
+            } else if (arg == "--find-name" && hasValue) {
+                options.nameQuery = argv[++i];
+            } else if (arg == "--shm-publish" && hasValue) {
+                options.sharedPublish = sharedName(argv[++i]);
+            } else if (arg == "--shm-attach" && hasValue) {
+                options.sharedAttach = sharedName(argv[++i]);
+            } else if (arg == "--shm-unlink" && hasValue) {
+                options.sharedUnlink = sharedName(argv[++i]);
+            } else if (arg == "--lookup" && hasValue) {
+                for (const auto& id : split(argv[++i], ',')) {
+                    if (!trim(id).empty()) options.lookupIDs.push_back(trim(id));
+                }
+            } else if (arg == "--profile") {
+                options.profile = true;
+            } else if (arg == "--memory-budget" && hasValue) {
+                options.memoryBudgetMB = std::stoul(argv[++i]);
+            } else if (arg == "--rank") {
+                options.rank = true;
+            } else if (arg == "--top" && hasValue) {
+                options.topCount = std::stoul(argv[++i]);
+            } else if (arg == "--checkpoint" && hasValue) {
+                options.checkpointPath = argv[++i];
+            } else if (arg == "--checkpoint-every" && hasValue) {
+                options.checkpointRows = std::stoul(argv[++i]);
+            } else if (arg == "--gzip" && hasValue) {
+                options.gzipLevel = std::stoi(argv[++i]);
+                if (options.gzipLevel < GZIP_MIN_LEVEL || options.gzipLevel > GZIP_MAX_LEVEL) {
+                    throw std::invalid_argument("--gzip expects a level from 0 to 9");
+                }
+            } else if (arg == "--threads" && hasValue) {
+                unsigned long threads = std::stoul(argv[++i]);
+                if (threads == 0) {
+                    throw std::invalid_argument("--threads expects at least 1");
+                }
+                // More threads than the hardware runs only adds contention
+                unsigned limit = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : MAX_THREADS;
+                if (threads > limit) {
+                    std::cout << "Note: --threads limited to " << limit << std::endl;
+                    threads = limit;
+                }
+                options.writerThreads = static_cast<unsigned>(threads);
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [--columnar <file>] [--threads <n>]"
+                          << " [--schemes <config>] [--what-if <file>]"
+                          << " [--transcripts <dir>] [--transcript-archive <file>]"
+                          << " [--bloom-fpr <rate>] [--concurrent-load] [--streaming]"
+                          << " [--bulk-validate] [--preview <rows>] [--workers <n>]"
+                          << " [--input-dir <dir>] [--output <file>] [--corrections <file>]"
+                          << " [--find-name <name>] [--shm-publish <name>] [--shm-attach <name>]"
+                          << " [--shm-unlink <name>] [--lookup <id,...>] [--memory-budget <MB>]"
+                          << " [--profile] [--course-filter <code|prefix*,...>] [--id-range <min>-<max>]"
+                          << " [--checkpoint <file> [--checkpoint-every <rows>]] [--rank] [--top <n>] [--gzip <level>]"
+                          << " [--dataset <dir> [--terms <t,...>] [--dataset-output <file>]]" << std::endl;
+                return false;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid option value: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
 std::vector<std::string> split(const std::string& str, char delimiter) {
     std::vector<std::string> tokens;
     std::stringstream ss(str);
@@ -0,0 +1,179 @@
+#include "memoryaccount.h"
+#include "exceptions.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// std::map's red-black node: colour and three links ahead of the value
+static const size_t MAP_NODE_LINKS = 4 * sizeof(void*);
+
+// Each open file stream owns one buffer of this size
+static const size_t STREAM_BUFFER = BUFSIZ;
+
+// Streams open during a load: NameFile.txt, CourseFile.txt and the output
+static const size_t LOAD_STREAMS = 3;
+
+// The staging vector grows by doubling, so it can hold up to twice its rows
+static const size_t STAGING_GROWTH = 2;
+
+static const size_t INLINE_STRING_CAPACITY = std::string().capacity();
+
+size_t MemoryFootprint::total() const {
+    return directory + courseSlots + strings + buffers;
+}
+
+MemoryAccount::MemoryAccount(size_t budgetBytes) : budget(budgetBytes), footprint(), stagedBytes(0), streamBytes(0) {}
+
+// malloc adds a size word to each block and rounds it up to 16 bytes
+size_t MemoryAccount::heapBlock(size_t bytes) {
+    return std::max<size_t>(4 * sizeof(size_t), (bytes + sizeof(size_t) + 15) & ~static_cast<size_t>(15));
+}
+
+// Short strings live inside the std::string object and cost nothing extra
+size_t MemoryAccount::stringBytes(const std::string& text) {
+    const char* object = reinterpret_cast<const char*>(&text);
+    bool inlined = text.data() >= object && text.data() < object + sizeof(text);
+    return inlined ? 0 : heapBlock(text.capacity() + 1);
+}
+
+size_t MemoryAccount::stringBytes(size_t length) {
+    return length > INLINE_STRING_CAPACITY ? heapBlock(length + 1) : 0;
+}
+
+static size_t mapNodeBytes() {
+    return MemoryAccount::heapBlock(MAP_NODE_LINKS + sizeof(std::pair<const std::string, Student>));
+}
+
+void MemoryAccount::measureStudents(const std::map<std::string, Student>& students) {
+    size_t node = mapNodeBytes();
+    footprint.directory = 0;
+    footprint.courseSlots = 0;
+    footprint.courseSlotsUsed = 0;
+    footprint.strings = 0;
+    for (const auto& [id, student] : students) {
+        footprint.directory += node - sizeof(Student::CourseList);
+        footprint.courseSlots += sizeof(Student::CourseList);
+        footprint.courseSlotsUsed += student.getCourseCount() * sizeof(Course);
+        footprint.strings += stringBytes(id) + stringBytes(student.getStudentID()) + stringBytes(student.getStudentName());
+        for (const auto& course : student.getCourses()) {
+            footprint.strings += stringBytes(course.getCourseCode());
+        }
+    }
+}
+
+void MemoryAccount::measureStagedCourses(const std::vector<CourseRecord>& staged) {
+    stagedBytes = staged.capacity() > 0 ? heapBlock(staged.capacity() * sizeof(CourseRecord)) : 0;
+    for (const auto& record : staged) {
+        stagedBytes += stringBytes(record.studentID) + stringBytes(record.courseCode) + stringBytes(record.error);
+    }
+    footprint.buffers = stagedBytes + streamBytes;
+}
+
+void MemoryAccount::measureStreams(size_t openFiles) {
+    streamBytes = openFiles * heapBlock(STREAM_BUFFER);
+    footprint.buffers = stagedBytes + streamBytes;
+}
+
+bool MemoryAccount::fitsBudget(const MemoryFootprint& projected) const {
+    return budget == 0 || projected.total() <= budget;
+}
+
+void MemoryAccount::checkBudget(const std::string& stage) const {
+    if (!fitsBudget(footprint)) {
+        throw MemoryBudgetException(stage + " holds " + formatMegabytes(footprint.total()) + " MB, over the "
+                                    + formatMegabytes(budget) + " MB budget; raise --memory-budget, drop the outputs"
+                                    " that need every student in memory, or use --streaming with inputs sorted by"
+                                    " student ID");
+    }
+}
+
+MemoryFootprint MemoryAccount::projectLoad(const SamplePreview& sample, bool stageCourses) {
+    const FileSample& names = sample.getNameSample();
+    const FileSample& courses = sample.getCourseSample();
+    MemoryFootprint projected = MemoryFootprint();
+    size_t node = mapNodeBytes();
+
+    // Sampled rows are sized as they would be stored, then scaled to the file
+    NameRecord name;
+    size_t fieldCount;
+    std::string error;
+    for (const auto& line : names.lines) {
+        if (NameFileSchema::parse(line, name, fieldCount, error) != RECORD_PARSED) {
+            continue;
+        }
+        projected.directory += node - sizeof(Student::CourseList);
+        projected.courseSlots += sizeof(Student::CourseList);
+        projected.strings += 2 * stringBytes(name.studentID.size()) + stringBytes(name.studentName.size());
+    }
+    double nameScale = names.lines.empty() ? 0.0 : names.estimatedRows / names.lines.size();
+    projected.directory = static_cast<size_t>(projected.directory * nameScale);
+    projected.courseSlots = static_cast<size_t>(projected.courseSlots * nameScale);
+    projected.strings = static_cast<size_t>(projected.strings * nameScale);
+
+    size_t courseStrings = 0;
+    CourseRecord course;
+    FieldSpan fields[CourseFileSchema::FIELD_COUNT];
+    for (const auto& line : courses.lines) {
+        if (CourseFileSchema::split(line, fields) != CourseFileSchema::FIELD_COUNT) {
+            continue;
+        }
+        CourseFileSchema::readFields<0, 2>(line, fields, course, error);
+        size_t idBytes = stringBytes(course.studentID.size());
+        size_t codeBytes = stringBytes(course.courseCode.size());
+        projected.courseSlotsUsed += sizeof(Course);
+        courseStrings += codeBytes;
+        if (stageCourses) {
+            projected.buffers += STAGING_GROWTH * sizeof(CourseRecord) + idBytes + codeBytes;
+        }
+    }
+    double courseScale = courses.lines.empty() ? 0.0 : courses.estimatedRows / courses.lines.size();
+    projected.courseSlotsUsed = std::min(projected.courseSlots, static_cast<size_t>(projected.courseSlotsUsed * courseScale));
+    projected.strings += static_cast<size_t>(courseStrings * courseScale);
+    projected.buffers = static_cast<size_t>(projected.buffers * courseScale) + LOAD_STREAMS * heapBlock(STREAM_BUFFER);
+    return projected;
+}
+
+size_t MemoryAccount::peakResidentBytes() {
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;   // kilobytes on Linux
+    }
+#endif
+    return 0;
+}
+
+std::string MemoryAccount::formatMegabytes(size_t bytes) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0);
+    return text.str();
+}
+
+void MemoryAccount::printReport() const {
+    double used = footprint.courseSlots > 0 ? 100.0 * footprint.courseSlotsUsed / footprint.courseSlots : 0.0;
+    std::cout << "Memory: directory " << formatMegabytes(footprint.directory) << " MB, course slots "
+              << formatMegabytes(footprint.courseSlots) << " MB (" << static_cast<int>(used + 0.5) << "% used), strings "
+              << formatMegabytes(footprint.strings) << " MB, buffers " << formatMegabytes(footprint.buffers)
+              << " MB; total " << formatMegabytes(footprint.total()) << " MB";
+    if (budget > 0) {
+        std::cout << " of " << formatMegabytes(budget) << " MB budget";
+    }
+    size_t peak = peakResidentBytes();
+    if (peak > 0) {
+        std::cout << "; peak RSS " << formatMegabytes(peak) << " MB";
+    }
+    std::cout << std::endl;
+}
+
+const MemoryFootprint& MemoryAccount::getFootprint() const {
+    return footprint;
+}
+
+size_t MemoryAccount::getBudget() const {
+    return budget;
+}
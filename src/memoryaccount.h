@@ -0,0 +1,62 @@
+#ifndef MEMORYACCOUNT_H
+#define MEMORYACCOUNT_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include "student.h"
+#include "filereader.h"
+#include "samplepreview.h"
+
+// Heap bytes held by each structure of a run
+struct MemoryFootprint {
+    size_t directory;           // std::map nodes: tree links, key and Student, less its course slots
+    size_t courseSlots;         // the MAX_COURSES course slots inside every Student
+    size_t courseSlotsUsed;     // slots holding a course
+    size_t strings;             // IDs, names and codes too long to be stored inline
+    size_t buffers;             // staged course rows and file stream buffers
+
+    size_t total() const;
+};
+
+// Accounts for the memory a load holds, by structure, and enforces an
+// optional budget. Sizes are worked out from the containers (node layout,
+// string capacities, malloc's block rounding) rather than read from the
+// allocator, so the same rules also project a load from a sample of the
+// inputs before anything is read.
+class MemoryAccount {
+    private:
+        size_t budget;              // bytes; 0 = no budget
+        MemoryFootprint footprint;
+        size_t stagedBytes;
+        size_t streamBytes;
+
+    public:
+        MemoryAccount(size_t budgetBytes = 0);
+
+        // Each replaces its part of the footprint with the current sizes
+        void measureStudents(const std::map<std::string, Student>& students);
+        void measureStagedCourses(const std::vector<CourseRecord>& staged);
+        void measureStreams(size_t openFiles);
+
+        // Throws MemoryBudgetException naming the stage if the footprint is over budget
+        void checkBudget(const std::string& stage) const;
+        bool fitsBudget(const MemoryFootprint& projected) const;
+
+        // Per-structure summary with the process's peak resident size
+        void printReport() const;
+
+        const MemoryFootprint& getFootprint() const;
+        size_t getBudget() const;
+
+        // Footprint of loading the sampled files in full, staged or not
+        static MemoryFootprint projectLoad(const SamplePreview& sample, bool stageCourses);
+
+        static size_t heapBlock(size_t bytes);
+        static size_t stringBytes(const std::string& text);
+        static size_t stringBytes(size_t length);
+        static size_t peakResidentBytes();
+        static std::string formatMegabytes(size_t bytes);
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "mergejoin.h"
+#include "exceptions.h"
+#include <iostream>
+
+// Students are only created with 9-character IDs, so a row with a blank or
+// malformed ID matches no one and says nothing about the file's order
+static const size_t STUDENT_ID_LENGTH = 9;
+
+static bool couldMatchStudent(const std::string& studentID) {
+    return studentID.size() == STUDENT_ID_LENGTH;
+}
+
+StreamingJoin::StreamingJoin(FileReader& names, FileReader& courses, FileWriter& output)
+    : nameFile(names), courseFile(courses), outputFile(output),
+      hasLookahead(false), studentsRead(0), studentsWritten(0) {}
+
+// Makes the next student current. Adjacent duplicate IDs keep the last
+// row, as students[id] = student does in readNameFile.
+bool StreamingJoin::advanceStudent() {
+    if (!hasLookahead) {
+        return false;
+    }
+
+    Student current = lookahead;
+    hasLookahead = nameFile.readNextStudent(lookahead);
+    while (hasLookahead && lookahead.getStudentID() == current.getStudentID()) {
+        current = lookahead;
+        hasLookahead = nameFile.readNextStudent(lookahead);
+    }
+    if (hasLookahead && lookahead.getStudentID() < current.getStudentID()) {
+        throw UnsortedInputException(nameFile.getFileName() + ": " + lookahead.getStudentID()
+                                     + " follows " + current.getStudentID());
+    }
+
+    studentsRead++;
+    window.clear();
+    window[current.getStudentID()] = current;
+    return true;
+}
+
+void StreamingJoin::emitCurrent() {
+    if (window.empty()) {
+        return;
+    }
+    const Student& student = window.begin()->second;
+    if (student.getCourseCount() > 0) {
+        outputFile.writeStudentRows(student);
+        studentsWritten++;
+    }
+    window.clear();
+}
+
+bool StreamingJoin::run() {
+    hasLookahead = nameFile.readNextStudent(lookahead);
+    advanceStudent();
+
+    CourseRecord record;
+    while (courseFile.readNextCourseRecord(record)) {
+        if (record.status != COURSE_RECORD_BAD_FORMAT && couldMatchStudent(record.studentID)) {
+            if (record.studentID < lastCourseID) {
+                throw UnsortedInputException(courseFile.getFileName() + ": " + record.studentID + " at line "
+                                             + std::to_string(record.lineNumber) + " follows " + lastCourseID);
+            }
+            lastCourseID = record.studentID;
+
+            // Students before this row's ID can get no more courses
+            while (!window.empty() && window.begin()->first < record.studentID) {
+                emitCurrent();
+                advanceStudent();
+            }
+        }
+        courseFile.applyCourseRecord(record, window);
+    }
+
+    emitCurrent();
+    while (advanceStudent()) {
+        emitCurrent();
+    }
+
+    outputFile.getFile().close();
+    courseFile.reportCourseStats();
+    std::cout << "Streamed " << studentsRead << " students, wrote " << studentsWritten
+              << " with courses to " << outputFile.getFileName() << std::endl;
+    return studentsWritten > 0;
+}
+
+size_t StreamingJoin::getStudentsRead() const {
+    return studentsRead;
+}
+
+size_t StreamingJoin::getStudentsWritten() const {
+    return studentsWritten;
+}
@@ -0,0 +1,40 @@
+#ifndef MERGEJOIN_H
+#define MERGEJOIN_H
+
+#include <string>
+#include <map>
+#include "filereader.h"
+#include "filewriter.h"
+
+// Streaming sort-merge join for inputs already sorted by student ID.
+// NameFile and CourseFile are read in step and each student's Output.txt
+// rows are written as soon as the course stream moves past that student,
+// so memory holds a single student's courses. Out-of-order IDs throw
+// UnsortedInputException; rows already written are then incomplete.
+class StreamingJoin {
+    private:
+        FileReader& nameFile;
+        FileReader& courseFile;
+        FileWriter& outputFile;
+
+        // One-student window handed to FileReader::applyCourseRecord
+        std::map<std::string, Student> window;
+        Student lookahead;
+        bool hasLookahead;
+        std::string lastCourseID;
+        size_t studentsRead;
+        size_t studentsWritten;
+
+        bool advanceStudent();
+        void emitCurrent();
+
+    public:
+        StreamingJoin(FileReader& names, FileReader& courses, FileWriter& output);
+
+        bool run();
+
+        size_t getStudentsRead() const;
+        size_t getStudentsWritten() const;
+};
+
+#endif
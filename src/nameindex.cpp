@@ -0,0 +1,164 @@
+#include "nameindex.h"
+#include <algorithm>
+#include <cctype>
+
+NameIndex::NameIndex() : built(false) {}
+
+NameIndex::NameIndex(const std::map<std::string, Student>& students) : built(false) {
+    entries.reserve(students.size());
+    for (const auto& [id, student] : students) {
+        add(id, student.getStudentName());
+    }
+    build();
+}
+
+// Lowercase with runs of whitespace collapsed, matching sanitizeName's spacing
+std::string NameIndex::normalize(const std::string& name) {
+    std::string result;
+    result.reserve(name.size());
+    bool space = false;
+    for (unsigned char c : name) {
+        if (std::isspace(c)) {
+            space = !result.empty();
+            continue;
+        }
+        if (space) {
+            result += ' ';
+            space = false;
+        }
+        result += static_cast<char>(std::tolower(c));
+    }
+    return result;
+}
+
+// FNV-1a
+uint32_t NameIndex::hash(const std::string& text) {
+    uint32_t value = 2166136261U;
+    for (unsigned char c : text) {
+        value ^= c;
+        value *= 16777619U;
+    }
+    return value;
+}
+
+bool NameIndex::withinOneEdit(const std::string& a, const std::string& b) {
+    const std::string& shorter = a.size() <= b.size() ? a : b;
+    const std::string& longer = a.size() <= b.size() ? b : a;
+    if (longer.size() - shorter.size() > 1) {
+        return false;
+    }
+
+    size_t prefix = 0;
+    while (prefix < shorter.size() && shorter[prefix] == longer[prefix]) {
+        prefix++;
+    }
+    if (prefix == shorter.size()) {
+        return true;   // equal, or one trailing insertion
+    }
+    // Substitution skips one character in each, insertion only in the longer one
+    size_t skip = shorter.size() == longer.size() ? 1 : 0;
+    return shorter.compare(prefix + skip, std::string::npos, longer, prefix + 1, std::string::npos) == 0;
+}
+
+void NameIndex::add(const std::string& studentID, const std::string& name) {
+    entries.emplace_back(normalize(name), studentID);
+    built = false;
+}
+
+void NameIndex::build() {
+    std::sort(entries.begin(), entries.end());
+
+    nameStarts.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i == 0 || entries[i].first != entries[i - 1].first) {
+            nameStarts.push_back(i);
+        }
+    }
+    size_t distinct = nameStarts.size();
+    nameStarts.push_back(entries.size());
+
+    variants.clear();
+    std::string deleted;
+    for (size_t n = 0; n < distinct; ++n) {
+        const std::string& name = entries[nameStarts[n]].first;
+        variants.push_back(static_cast<uint64_t>(hash(name)) << 32 | n);
+        for (size_t i = 0; i < name.size(); ++i) {
+            if (i > 0 && name[i] == name[i - 1]) {
+                continue;   // deleting either of a repeated pair gives the same string
+            }
+            deleted.assign(name, 0, i);
+            deleted.append(name, i + 1, std::string::npos);
+            variants.push_back(static_cast<uint64_t>(hash(deleted)) << 32 | n);
+        }
+    }
+    std::sort(variants.begin(), variants.end());
+    built = true;
+}
+
+void NameIndex::appendIDs(size_t name, std::vector<std::string>& ids) const {
+    for (size_t i = nameStarts[name]; i < nameStarts[name + 1]; ++i) {
+        ids.push_back(entries[i].second);
+    }
+}
+
+std::vector<std::string> NameIndex::findPrefix(const std::string& prefix, size_t limit) const {
+    std::vector<std::string> ids;
+    if (!built) {
+        return ids;
+    }
+    std::string key = normalize(prefix);
+    auto it = std::lower_bound(entries.begin(), entries.end(), key,
+        [](const std::pair<std::string, std::string>& entry, const std::string& value) {
+            return entry.first < value;
+        });
+    for (; it != entries.end() && it->first.compare(0, key.size(), key) == 0; ++it) {
+        if (limit > 0 && ids.size() >= limit) {
+            break;
+        }
+        ids.push_back(it->second);
+    }
+    return ids;
+}
+
+std::vector<std::string> NameIndex::findSimilar(const std::string& name) const {
+    std::vector<std::string> ids;
+    if (!built) {
+        return ids;
+    }
+    std::string key = normalize(name);
+
+    // Probe the query and its deletions; hash collisions are removed by the final check
+    std::vector<uint32_t> probes;
+    probes.push_back(hash(key));
+    std::string deleted;
+    for (size_t i = 0; i < key.size(); ++i) {
+        deleted.assign(key, 0, i);
+        deleted.append(key, i + 1, std::string::npos);
+        probes.push_back(hash(deleted));
+    }
+
+    std::vector<uint32_t> candidates;
+    for (uint32_t probe : probes) {
+        auto it = std::lower_bound(variants.begin(), variants.end(), static_cast<uint64_t>(probe) << 32);
+        for (; it != variants.end() && (*it >> 32) == probe; ++it) {
+            candidates.push_back(static_cast<uint32_t>(*it));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (uint32_t candidate : candidates) {
+        if (withinOneEdit(entries[nameStarts[candidate]].first, key)) {
+            appendIDs(candidate, ids);
+        }
+    }
+    return ids;
+}
+
+size_t NameIndex::getNameCount() const {
+    return entries.size();
+}
+
+size_t NameIndex::getDistinctNameCount() const {
+    return nameStarts.empty() ? 0 : nameStarts.size() - 1;
+}
@@ -0,0 +1,49 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "student.h"
+
+// Student lookup by name. Names are normalized (lowercase, single spaces)
+// and kept in a sorted array, so a prefix search is a binary search followed
+// by a short forward scan. Tolerant lookup uses a deletion neighbourhood:
+// every distinct name is also indexed under each one-character deletion, and
+// two strings within one edit of each other always share such a variant.
+class NameIndex {
+    private:
+        // (normalized name, student ID), sorted
+        std::vector<std::pair<std::string, std::string>> entries;
+        // First entry of each distinct name, plus entries.size() at the end
+        std::vector<size_t> nameStarts;
+        // Hash of a name or one of its deletions in the high 32 bits, distinct
+        // name number in the low 32; sorted
+        std::vector<uint64_t> variants;
+        bool built;
+
+        static uint32_t hash(const std::string& text);
+        void appendIDs(size_t name, std::vector<std::string>& ids) const;
+
+    public:
+        NameIndex();
+        NameIndex(const std::map<std::string, Student>& students);
+
+        // add() any number of names, then build() once before searching
+        void add(const std::string& studentID, const std::string& name);
+        void build();
+
+        // IDs of students whose name starts with prefix, ordered by name; 0 = no limit
+        std::vector<std::string> findPrefix(const std::string& prefix, size_t limit = 0) const;
+        // IDs of students whose name is within edit distance 1 of name
+        std::vector<std::string> findSimilar(const std::string& name) const;
+
+        size_t getNameCount() const;
+        size_t getDistinctNameCount() const;
+
+        static std::string normalize(const std::string& name);
+        static bool withinOneEdit(const std::string& a, const std::string& b);
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "outputmanifest.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+static const char OUTPUT_MANIFEST_VERSION[] = "CP317 output manifest 1";
+
+OutputManifest::OutputManifest(const std::string& outputPath)
+    : outputName(outputPath), manifestName(outputPath + ".manifest"), snapshotName(outputPath + ".snapshot") {}
+
+// "<path> <size> <mtime>", or "-" for a missing file
+std::string OutputManifest::describeFile(const std::string& path) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    if (path.empty() || error) {
+        return "-";
+    }
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return "-";
+    }
+    return path + " " + std::to_string(size) + " " + std::to_string(time.time_since_epoch().count());
+}
+
+void OutputManifest::addInput(const std::string& key, const std::string& path) {
+    settings.push_back(key + " " + describeFile(path));
+}
+
+void OutputManifest::addSetting(const std::string& key, const std::string& value) {
+    settings.push_back(key + " " + (value.empty() ? "-" : value));
+}
+
+std::vector<std::string> OutputManifest::describeState() const {
+    std::vector<std::string> state;
+    state.push_back(OUTPUT_MANIFEST_VERSION);
+    state.insert(state.end(), settings.begin(), settings.end());
+    state.push_back("snapshot " + describeFile(snapshotName));
+    state.push_back("output " + describeFile(outputName));
+    return state;
+}
+
+bool OutputManifest::matches() const {
+    std::ifstream in(manifestName);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::vector<std::string> recorded;
+    std::string line;
+    while (std::getline(in, line)) {
+        recorded.push_back(line);
+    }
+    std::vector<std::string> current = describeState();
+    return recorded == current && current.back() != "output -" && current[current.size() - 2] != "snapshot -";
+}
+
+bool OutputManifest::save() {
+    std::ofstream out(manifestName, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Cannot open file: " << manifestName << std::endl;
+        return false;
+    }
+    for (const auto& line : describeState()) {
+        out << line << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+const std::string& OutputManifest::getManifestName() const {
+    return manifestName;
+}
+
+void OutputManifest::remove() {
+    std::remove(manifestName.c_str());
+}
+
+const std::string& OutputManifest::getSnapshotName() const {
+    return snapshotName;
+}
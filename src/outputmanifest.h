@@ -0,0 +1,45 @@
+#ifndef OUTPUTMANIFEST_H
+#define OUTPUTMANIFEST_H
+
+#include <string>
+#include <vector>
+
+// Sidecar describing how an Output.txt was produced, kept next to it as
+// "<output>.manifest" by runs given --corrections. It records the inputs'
+// sizes and mtimes, the settings that shape the rows (schemes, filters,
+// format), and the sizes and mtimes of the output and of its snapshot
+// ("<output>.snapshot", see outputsnapshot.h), which holds the students with
+// every correction so far. A corrections run starts from the snapshot only
+// when all of these still match; anything else, including another writer
+// touching either file, means loading the inputs and a full rewrite.
+
+class OutputManifest {
+    private:
+        std::string outputName;
+        std::string manifestName;
+        std::string snapshotName;
+        std::vector<std::string> settings;      // "<key> <value>" lines describing this run
+
+        static std::string describeFile(const std::string& path);
+        std::vector<std::string> describeState() const;
+
+    public:
+        OutputManifest(const std::string& outputPath);
+
+        // An input file, recorded with its size and mtime; "-" if the path is empty
+        void addInput(const std::string& key, const std::string& path);
+        void addSetting(const std::string& key, const std::string& value);
+
+        // True if the output and snapshot were last written by a run with these settings and are unchanged since
+        bool matches() const;
+
+        // Records the output and snapshot as written just now
+        bool save();
+        // After a failed snapshot, so the next corrections run starts over
+        void remove();
+
+        const std::string& getManifestName() const;
+        const std::string& getSnapshotName() const;
+};
+
+#endif
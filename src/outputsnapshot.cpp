@@ -0,0 +1,315 @@
+#include "outputsnapshot.h"
+#include "exceptions.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+// Records read or rewritten at a time when spans move
+static const uint64_t SNAPSHOT_CHUNK_RECORDS = 4096;
+
+static uint64_t recordPosition(uint64_t index) {
+    return sizeof(OutputSnapshotHeader) + index * sizeof(OutputSnapshotRecord);
+}
+
+OutputSnapshot::OutputSnapshot(const std::string& snapshotPath)
+    : path(snapshotPath), studentCount(0), rowsIndexed(false) {}
+
+// The record count must account for the whole file, checked before anything is read
+bool OutputSnapshot::readHeader(std::istream& in) {
+    OutputSnapshotHeader header;
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(path, error);
+    if (error || !in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, OUTPUT_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+        || header.version != OUTPUT_SNAPSHOT_VERSION
+        || header.studentCount != (fileSize - sizeof(header)) / sizeof(OutputSnapshotRecord)
+        || (fileSize - sizeof(header)) % sizeof(OutputSnapshotRecord) != 0) {
+        std::cerr << "Warning: Snapshot " << path << " is malformed" << std::endl;
+        return false;
+    }
+    studentCount = header.studentCount;
+    rowsIndexed = header.rowsIndexed != 0;
+    return true;
+}
+
+// False if a field is too long for its slot
+bool OutputSnapshot::fillRecord(const Student& student, OutputSnapshotRecord& record) {
+    std::memset(&record, 0, sizeof(record));
+    const std::string& id = student.getStudentID();
+    const std::string& name = student.getStudentName();
+    if (id.size() >= sizeof(record.studentID) || name.size() >= sizeof(record.studentName)) {
+        return false;
+    }
+    std::memcpy(record.studentID, id.data(), id.size());
+    std::memcpy(record.studentName, name.data(), name.size());
+    record.courseCount = static_cast<uint32_t>(student.getCourseCount());
+    for (size_t c = 0; c < student.getCourseCount(); ++c) {
+        const Course& course = student.getCourses()[c];
+        OutputSnapshotCourse& stored = record.courses[c];
+        if (course.getCourseCode().size() >= sizeof(stored.courseCode)) {
+            return false;
+        }
+        std::memcpy(stored.courseCode, course.getCourseCode().data(), course.getCourseCode().size());
+        stored.test1 = course.getTest1();
+        stored.test2 = course.getTest2();
+        stored.test3 = course.getTest3();
+        stored.finalExam = course.getFinalExam();
+    }
+    return true;
+}
+
+bool OutputSnapshot::readRecord(const OutputSnapshotRecord& record, Student& student) {
+    if (record.courseCount > Student::MAX_COURSES) {
+        return false;
+    }
+    student = Student();
+    student.setStudentID(std::string(record.studentID, strnlen(record.studentID, sizeof(record.studentID))));
+    student.setStudentName(std::string(record.studentName, strnlen(record.studentName, sizeof(record.studentName))));
+    for (uint32_t c = 0; c < record.courseCount; ++c) {
+        const OutputSnapshotCourse& stored = record.courses[c];
+        // A duplicate is stored before it is reported, as when it was first read
+        try {
+            student.addValidatedCourse(Course::createValidated(
+                std::string(stored.courseCode, strnlen(stored.courseCode, sizeof(stored.courseCode))),
+                stored.test1, stored.test2, stored.test3, stored.finalExam));
+        } catch (const CourseAlreadyExists&) {
+        }
+    }
+    return true;
+}
+
+bool OutputSnapshot::save(const std::map<std::string, Student>& students, const std::string& outputPath) {
+    OutputSnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, OUTPUT_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = OUTPUT_SNAPSHOT_VERSION;
+    header.rowsIndexed = outputPath.empty() ? 0 : 1;
+    header.studentCount = students.size();
+
+    std::ifstream output;
+    if (header.rowsIndexed) {
+        output.open(outputPath, std::ios::binary);
+        if (!output.is_open()) {
+            std::cerr << "Cannot open file: " << outputPath << std::endl;
+            return false;
+        }
+    }
+
+    // Written beside the target and renamed into place, like a checkpoint
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(temporary);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Rows are in ID order, so one pass over the output gives every span
+    std::string line;
+    bool pending = header.rowsIndexed && std::getline(output, line);
+    uint64_t offset = 0;
+    bool complete = true;
+    OutputSnapshotRecord record;
+    for (const auto& [id, student] : students) {
+        if (!fillRecord(student, record)) {
+            std::cerr << "Warning: Student " << id << " does not fit a snapshot record" << std::endl;
+            complete = false;
+            break;
+        }
+        record.rowOffset = offset;
+        size_t rows = 0;
+        while (pending && line.compare(0, line.find(','), id) == 0) {
+            offset += line.size() + (output.eof() ? 0 : 1);
+            rows++;
+            pending = static_cast<bool>(std::getline(output, line));
+        }
+        record.rowLength = offset - record.rowOffset;
+        if (header.rowsIndexed && rows != student.getCourseCount()) {
+            complete = false;
+            break;
+        }
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    if (complete && pending) {
+        complete = false;
+    }
+    if (!complete && header.rowsIndexed) {
+        std::cerr << "Warning: " << outputPath << " does not hold the rows of the students written" << std::endl;
+    }
+
+    out.close();
+    if (!complete || !out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    studentCount = header.studentCount;
+    rowsIndexed = header.rowsIndexed != 0;
+    return true;
+}
+
+bool OutputSnapshot::loadAll(std::map<std::string, Student>& students) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Cannot open file: " << path << std::endl;
+        return false;
+    }
+    if (!readHeader(in)) {
+        return false;
+    }
+
+    students.clear();
+    std::vector<OutputSnapshotRecord> chunk;
+    for (uint64_t i = 0; i < studentCount; i += chunk.size()) {
+        chunk.resize(std::min(SNAPSHOT_CHUNK_RECORDS, studentCount - i));
+        if (!in.read(reinterpret_cast<char*>(chunk.data()), chunk.size() * sizeof(OutputSnapshotRecord))) {
+            throw FileAccessException(path);
+        }
+        for (const auto& record : chunk) {
+            Student student;
+            if (!readRecord(record, student)) {
+                std::cerr << "Warning: Snapshot " << path << " is malformed" << std::endl;
+                students.clear();
+                return false;
+            }
+            std::string id = student.getStudentID();
+            students.emplace_hint(students.end(), std::move(id), std::move(student));
+        }
+    }
+    return true;
+}
+
+bool OutputSnapshot::loadStudents(const std::set<std::string>& ids, std::map<std::string, Student>& students) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Cannot open file: " << path << std::endl;
+        return false;
+    }
+    if (!readHeader(in)) {
+        return false;
+    }
+
+    recordIndex.clear();
+    spans.clear();
+    OutputSnapshotRecord record;
+    for (const auto& id : ids) {
+        if (id.empty() || id.size() >= sizeof(record.studentID)) {
+            continue;
+        }
+        // Lower bound over the on-disk records, as RowIndex::find does
+        uint64_t low = 0, high = studentCount;
+        while (low < high) {
+            uint64_t mid = low + (high - low) / 2;
+            in.seekg(recordPosition(mid));
+            if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+                throw FileAccessException(path);
+            }
+            if (std::strncmp(record.studentID, id.c_str(), sizeof(record.studentID)) < 0) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low == studentCount) {
+            continue;
+        }
+        in.seekg(recordPosition(low));
+        if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            throw FileAccessException(path);
+        }
+        if (std::strncmp(record.studentID, id.c_str(), sizeof(record.studentID)) != 0) {
+            continue;
+        }
+        Student student;
+        if (!readRecord(record, student)) {
+            std::cerr << "Warning: Snapshot " << path << " is malformed" << std::endl;
+            return false;
+        }
+        students[id] = std::move(student);
+        recordIndex[id] = low;
+        spans[id] = OutputSpan{record.rowOffset, record.rowLength};
+    }
+    return true;
+}
+
+bool OutputSnapshot::update(const std::map<std::string, Student>& students, const std::map<std::string, uint64_t>& rowLengths) {
+    std::map<uint64_t, std::string> changed;   // record index to ID, in file order
+    for (const auto& [id, length] : rowLengths) {
+        auto index = recordIndex.find(id);
+        if (index == recordIndex.end() || students.count(id) == 0) {
+            std::cerr << "Warning: Student " << id << " was not read from snapshot " << path << std::endl;
+            return false;
+        }
+        changed[index->second] = id;
+    }
+    if (changed.empty()) {
+        return true;
+    }
+
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open file: " << path << std::endl;
+        return false;
+    }
+
+    // Until a length changes only the changed records are touched; after that,
+    // every later record's offset moves, so the rest go in chunks
+    std::vector<OutputSnapshotRecord> chunk;
+    int64_t shift = 0;
+    uint64_t i = changed.begin()->first;
+    while (i < studentCount) {
+        if (shift == 0) {
+            auto next = changed.lower_bound(i);
+            if (next == changed.end()) {
+                break;
+            }
+            i = next->first;
+        }
+        chunk.resize(shift == 0 ? 1 : std::min(SNAPSHOT_CHUNK_RECORDS, studentCount - i));
+        file.seekg(recordPosition(i));
+        if (!file.read(reinterpret_cast<char*>(chunk.data()), chunk.size() * sizeof(OutputSnapshotRecord))) {
+            throw FileAccessException(path);
+        }
+        for (size_t c = 0; c < chunk.size(); ++c) {
+            OutputSnapshotRecord& record = chunk[c];
+            record.rowOffset += shift;
+            auto student = changed.find(i + c);
+            if (student == changed.end()) {
+                continue;
+            }
+            uint64_t offset = record.rowOffset;
+            uint64_t oldLength = record.rowLength;
+            if (!fillRecord(students.at(student->second), record)) {
+                std::cerr << "Warning: Student " << student->second << " does not fit a snapshot record" << std::endl;
+                return false;
+            }
+            record.rowOffset = offset;
+            record.rowLength = rowLengths.at(student->second);
+            shift += static_cast<int64_t>(record.rowLength) - static_cast<int64_t>(oldLength);
+            spans[student->second] = OutputSpan{record.rowOffset, record.rowLength};
+        }
+        file.seekp(recordPosition(i));
+        file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(OutputSnapshotRecord));
+        i += chunk.size();
+    }
+    file.close();
+    if (!file) {
+        throw FileAccessException(path);
+    }
+    return true;
+}
+
+bool OutputSnapshot::hasRowIndex() const {
+    return rowsIndexed;
+}
+
+OutputSpan OutputSnapshot::getSpan(const std::string& studentID) const {
+    auto it = spans.find(studentID);
+    return it != spans.end() ? it->second : OutputSpan{0, 0};
+}
+
+const std::string& OutputSnapshot::getPath() const {
+    return path;
+}
@@ -0,0 +1,87 @@
+#ifndef OUTPUTSNAPSHOT_H
+#define OUTPUTSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include <set>
+#include "student.h"
+
+// The students an Output.txt was written from, kept next to it as
+// "<output>.snapshot" so a corrections run starts from them instead of
+// reloading the inputs and replaying every earlier correction. Records have
+// a fixed size and are sorted by ID, so one student is found with a handful
+// of seeks and rewritten in place. Each record also holds the byte offset and
+// length of the student's rows in Output.txt, which is how those rows are
+// patched without reading the rest of the file.
+//
+//  [OutputSnapshotHeader][OutputSnapshotRecord x studentCount]
+
+const char OUTPUT_SNAPSHOT_MAGIC[8] = {'C', 'P', '3', '1', '7', 'S', 'N', 'P'};
+const uint32_t OUTPUT_SNAPSHOT_VERSION = 1;
+
+struct OutputSnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rowsIndexed;       // 0 when the output was not plain text; spans are then unset
+    uint64_t studentCount;
+};
+
+struct OutputSnapshotCourse {
+    char courseCode[8];         // zero padded
+    float test1, test2, test3, finalExam;
+};
+
+struct OutputSnapshotRecord {
+    char studentID[16];         // zero padded
+    char studentName[104];      // names are at most 100 characters
+    uint32_t courseCount;
+    uint32_t reserved;
+    uint64_t rowOffset;         // where the student's rows start in the output
+    uint64_t rowLength;         // bytes of rows; 0 for a student with no courses
+    OutputSnapshotCourse courses[Student::MAX_COURSES];
+};
+
+// Where one student's rows are in the output
+struct OutputSpan {
+    uint64_t offset;
+    uint64_t length;
+};
+
+class OutputSnapshot {
+    private:
+        std::string path;
+        uint64_t studentCount;
+        bool rowsIndexed;
+        std::map<std::string, uint64_t> recordIndex;   // of the students loadStudents read
+        std::map<std::string, OutputSpan> spans;
+
+        bool readHeader(std::istream& in);
+        static bool fillRecord(const Student& student, OutputSnapshotRecord& record);
+        static bool readRecord(const OutputSnapshotRecord& record, Student& student);
+
+    public:
+        OutputSnapshot(const std::string& snapshotPath);
+
+        // Records every student; with an output path, also where each one's rows are in it.
+        // False if a student does not fit a record or the output does not match the students
+        bool save(const std::map<std::string, Student>& students, const std::string& outputPath);
+
+        bool loadAll(std::map<std::string, Student>& students);
+
+        // Reads only the given students; IDs the snapshot lacks are left out
+        bool loadStudents(const std::set<std::string>& ids, std::map<std::string, Student>& students);
+
+        bool hasRowIndex() const;
+        // Of a student loadStudents read
+        OutputSpan getSpan(const std::string& studentID) const;
+
+        // Stores the changed students' courses and row lengths. Spans after a changed
+        // student move by the difference in its length, so only the records from the
+        // first length change onward are rewritten
+        bool update(const std::map<std::string, Student>& students, const std::map<std::string, uint64_t>& rowLengths);
+
+        const std::string& getPath() const;
+};
+
+#endif
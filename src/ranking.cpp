@@ -0,0 +1,204 @@
+#include "ranking.h"
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+
+// Below this many keys per run, another thread costs more than it saves
+static const size_t MIN_RUN_KEYS = 1 << 14;
+
+// NaN grades pass the range checks, so a NaN average is possible; it ranks last
+static bool isNumber(float value) {
+    return value == value;
+}
+
+static bool sameAverage(float a, float b) {
+    return a == b || (!isNumber(a) && !isNumber(b));
+}
+
+static float percentileOf(uint32_t rank, size_t groupSize) {
+    return 100.0f * static_cast<float>(groupSize - rank + 1) / static_cast<float>(groupSize);
+}
+
+// Ranks the head of a group in ranking order: tied averages share the rank of the first
+static void assignRanks(const std::vector<float>& averages, std::vector<RankEntry>& entries, size_t groupSize) {
+    for (size_t i = 0; i < averages.size(); ++i) {
+        bool tied = i > 0 && sameAverage(averages[i], averages[i - 1]);
+        entries[i].rank = tied ? entries[i - 1].rank : static_cast<uint32_t>(i + 1);
+        entries[i].percentile = percentileOf(entries[i].rank, groupSize);
+    }
+}
+
+bool Ranking::before(const RankKey& a, const RankKey& b) {
+    if (isNumber(a.average) != isNumber(b.average)) {
+        return isNumber(a.average);
+    }
+    return sameAverage(a.average, b.average) ? a.student < b.student : a.average > b.average;
+}
+
+// The built-in formula's average is memoized in Student; config schemes are summed here
+float Ranking::averageOf(const Student& student, const GradeEngine* engine) {
+    if (!engine || engine->usesBuiltInFormula() || student.getCourseCount() == 0) {
+        return student.getOverallAverage();
+    }
+    float totalGrade = 0.0f;
+    for (const auto& course : student.getCourses()) {
+        totalGrade += engine->calculateFinalGrade(course);
+    }
+    return totalGrade / student.getCourseCount();
+}
+
+std::vector<RankKey> Ranking::buildKeys(const std::vector<const Student*>& students, const GradeEngine* engine) {
+    std::vector<RankKey> keys(students.size());
+    for (size_t i = 0; i < students.size(); ++i) {
+        keys[i].average = averageOf(*students[i], engine);
+        keys[i].student = static_cast<uint32_t>(i);
+    }
+    return keys;
+}
+
+void Ranking::sortKeys(std::vector<RankKey>& keys, unsigned threadCount) {
+    size_t runs = std::max<size_t>(1, std::min<size_t>(threadCount, keys.size() / MIN_RUN_KEYS));
+    std::vector<size_t> bounds;
+    for (size_t r = 0; r <= runs; ++r) {
+        bounds.push_back(keys.size() * r / runs);
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t r = 0; r < runs; ++r) {
+        workers.emplace_back([&keys, &bounds, r]() {
+            std::sort(keys.begin() + bounds[r], keys.begin() + bounds[r + 1], before);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Each round merges neighbouring runs into the other buffer, halving the runs
+    std::vector<RankKey> merged(keys.size());
+    while (bounds.size() > 2) {
+        std::vector<size_t> next;
+        workers.clear();
+        for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            size_t first = bounds[r], middle = bounds[r + 1];
+            size_t last = r + 2 < bounds.size() ? bounds[r + 2] : middle;
+            workers.emplace_back([&keys, &merged, first, middle, last]() {
+                std::merge(keys.begin() + first, keys.begin() + middle, keys.begin() + middle, keys.begin() + last,
+                           merged.begin() + first, before);
+            });
+            next.push_back(first);
+        }
+        next.push_back(keys.size());
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        keys.swap(merged);
+        bounds.swap(next);
+    }
+}
+
+Ranking::Ranking(const std::map<std::string, Student>& students, unsigned threadCount, const GradeEngine* engine) {
+    directory.reserve(students.size());
+    firstCourse.reserve(students.size() + 1);
+    firstCourse.push_back(0);
+    for (const auto& [id, student] : students) {
+        directory.push_back(&student);
+        firstCourse.push_back(firstCourse.back() + static_cast<uint32_t>(student.getCourseCount()));
+    }
+
+    std::vector<RankKey> keys = buildKeys(directory, engine);
+    sortKeys(keys, threadCount);
+
+    std::vector<float> averages(keys.size());
+    std::vector<float> studentAverages(keys.size());
+    std::vector<RankEntry> ordered(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        averages[i] = keys[i].average;
+        studentAverages[keys[i].student] = keys[i].average;
+    }
+    assignRanks(averages, ordered, averages.size());
+    cohort.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        cohort[keys[i].student] = ordered[i];
+    }
+
+    // Course lists hold course slots, appended in cohort order
+    std::unordered_map<std::string, size_t> courseIndex;
+    std::vector<std::vector<uint32_t>> courseSlots;
+    for (const auto& key : keys) {
+        const Student::CourseList& courses = directory[key.student]->getCourses();
+        for (size_t c = 0; c < courses.size(); ++c) {
+            auto found = courseIndex.emplace(courses[c].getCourseCode(), courseSlots.size());
+            if (found.second) {
+                courseSlots.emplace_back();
+            }
+            courseSlots[found.first->second].push_back(firstCourse[key.student] + static_cast<uint32_t>(c));
+        }
+    }
+
+    std::vector<uint32_t> slotStudent(firstCourse.back());
+    for (size_t s = 0; s < directory.size(); ++s) {
+        for (uint32_t slot = firstCourse[s]; slot < firstCourse[s + 1]; ++slot) {
+            slotStudent[slot] = static_cast<uint32_t>(s);
+        }
+    }
+    courseRanks.resize(firstCourse.back());
+    for (const auto& slots : courseSlots) {
+        averages.resize(slots.size());
+        ordered.resize(slots.size());
+        for (size_t i = 0; i < slots.size(); ++i) {
+            averages[i] = studentAverages[slotStudent[slots[i]]];
+        }
+        assignRanks(averages, ordered, averages.size());
+        for (size_t i = 0; i < slots.size(); ++i) {
+            courseRanks[slots[i]] = ordered[i];
+        }
+    }
+}
+
+size_t Ranking::indexOf(const std::string& studentID) const {
+    auto it = std::lower_bound(directory.begin(), directory.end(), studentID,
+        [](const Student* student, const std::string& id) { return student->getStudentID() < id; });
+    if (it == directory.end() || (*it)->getStudentID() != studentID) {
+        return NOT_FOUND;
+    }
+    return static_cast<size_t>(it - directory.begin());
+}
+
+const RankEntry& Ranking::getCohortRank(size_t student) const {
+    return cohort[student];
+}
+
+const RankEntry& Ranking::getCourseRank(size_t student, size_t course) const {
+    return courseRanks[firstCourse[student] + course];
+}
+
+size_t Ranking::getStudentCount() const {
+    return directory.size();
+}
+
+std::vector<RankedStudent> Ranking::top(const std::map<std::string, Student>& students, size_t count,
+                                        const GradeEngine* engine) {
+    std::vector<const Student*> ordered;
+    ordered.reserve(students.size());
+    for (const auto& [id, student] : students) {
+        ordered.push_back(&student);
+    }
+    std::vector<RankKey> keys = buildKeys(ordered, engine);
+    count = std::min(count, keys.size());
+    std::nth_element(keys.begin(), keys.begin() + count, keys.end(), before);
+    std::sort(keys.begin(), keys.begin() + count, before);
+
+    // Everyone ahead of a top student is in the top too, so ranks come out the same
+    std::vector<float> averages(count);
+    std::vector<RankEntry> entries(count);
+    for (size_t i = 0; i < count; ++i) {
+        averages[i] = keys[i].average;
+    }
+    assignRanks(averages, entries, keys.size());
+
+    std::vector<RankedStudent> best(count);
+    for (size_t i = 0; i < count; ++i) {
+        best[i] = {ordered[keys[i].student], keys[i].average, entries[i]};
+    }
+    return best;
+}
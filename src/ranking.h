@@ -0,0 +1,69 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include "student.h"
+#include "gradeengine.h"
+
+// Sort key for one student; eight bytes, so millions sort in cache-sized runs
+struct RankKey {
+    float average;
+    uint32_t student;           // index in ID order
+};
+
+struct RankEntry {
+    uint32_t rank;              // 1 = highest average; equal averages share a rank
+    float percentile;           // share of the group ranked at or below, 0-100
+};
+
+struct RankedStudent {
+    const Student* student;
+    float average;
+    RankEntry rank;
+};
+
+// Every student ranked by the average of their final grades, as Output.txt
+// shows them (the GradeEngine's schemes, or Student::getOverallAverage for the
+// built-in formula), across the cohort and within each course they take. Order is by average, highest first, then by
+// student ID, so ties come out the same for any thread count. The cohort is
+// sorted once, in parallel; walking it in that order fills each course's
+// list already sorted, so course ranks need no sort of their own.
+class Ranking {
+    private:
+        std::vector<const Student*> directory;      // ID order
+        std::vector<RankEntry> cohort;              // per student
+        std::vector<uint32_t> firstCourse;          // per student, into courseRanks
+        std::vector<RankEntry> courseRanks;         // per student course, in the student's course order
+
+        static float averageOf(const Student& student, const GradeEngine* engine);
+        static std::vector<RankKey> buildKeys(const std::vector<const Student*>& students, const GradeEngine* engine);
+
+    public:
+        static const size_t NOT_FOUND = static_cast<size_t>(-1);
+
+        // engine grades the courses; nullptr for the built-in formula
+        Ranking(const std::map<std::string, Student>& students, unsigned threadCount = 1,
+                const GradeEngine* engine = nullptr);
+
+        // Binary search by ID; NOT_FOUND if absent
+        size_t indexOf(const std::string& studentID) const;
+
+        const RankEntry& getCohortRank(size_t student) const;
+        const RankEntry& getCourseRank(size_t student, size_t course) const;
+        size_t getStudentCount() const;
+
+        // Ranking order: higher average first, then lower ID
+        static bool before(const RankKey& a, const RankKey& b);
+
+        // Sorts runs on threadCount threads, then merges them pairwise in parallel
+        static void sortKeys(std::vector<RankKey>& keys, unsigned threadCount);
+
+        // The count best students, best first, by selection rather than a full sort
+        static std::vector<RankedStudent> top(const std::map<std::string, Student>& students, size_t count,
+                                              const GradeEngine* engine = nullptr);
+};
+
+#endif
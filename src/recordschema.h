@@ -0,0 +1,151 @@
+#ifndef RECORDSCHEMA_H
+#define RECORDSCHEMA_H
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <exception>
+#include <cerrno>
+#include <cstdlib>
+
+// Declarative record layouts for delimited input files. A schema names the
+// record type, the delimiter and one Field per column; the templates below
+// expand it into a parser for exactly that layout, with every field's
+// conversion and validator inlined and no per-field dispatch at run time.
+//
+//   typedef RecordSchema<CourseRecord, ',',
+//       Field<TextField, &CourseRecord::studentID>,
+//       Field<FloatField, &CourseRecord::test1, SingleGradeExceptionCheck>, ...> Schema;
+
+// One field of a line, trimmed like trim() does
+struct FieldSpan {
+    size_t begin;
+    size_t end;
+};
+
+// The span's bytes, unconverted, for predicates on the raw line
+inline std::string_view fieldText(const std::string& line, const FieldSpan& span) {
+    return std::string_view(line).substr(span.begin, span.end - span.begin);
+}
+
+enum RecordParseStatus {
+    RECORD_PARSED,
+    RECORD_BAD_FORMAT,          // wrong field count
+    RECORD_BAD_VALUE            // a field failed to convert or validate
+};
+
+// Field types: convert one span of the line into the record member
+
+struct TextField {
+    static constexpr const char* ERROR = "";
+
+    static bool read(const std::string& line, const FieldSpan& span, std::string& value) {
+        value.assign(line, span.begin, span.end - span.begin);   // reuses the member's capacity
+        return true;
+    }
+};
+
+// std::stof on the span in place; strtof stops at the span's end because
+// only whitespace and the delimiter follow it
+struct FloatField {
+    static constexpr const char* ERROR = "stof";    // what std::stof reports for both failures
+
+    static bool read(const std::string& line, const FieldSpan& span, float& value) {
+        const char* begin = line.c_str() + span.begin;
+        char* end;
+        errno = 0;
+        value = std::strtof(begin, &end);
+        return end != begin && errno != ERANGE;
+    }
+};
+
+// A column: its type, the record member it fills and an optional validator,
+// any function taking the value that throws on bad input (the exceptions.h checks)
+template <typename Type, auto Member, auto Check = nullptr>
+struct Field {
+    template <typename Record>
+    static bool read(const std::string& line, const FieldSpan& span, Record& record, std::string& error) {
+        auto& value = record.*Member;
+        if (!Type::read(line, span, value)) {
+            error = Type::ERROR;
+            return false;
+        }
+        if constexpr (!std::is_same<decltype(Check), std::nullptr_t>::value) {
+            try {
+                Check(value);
+            } catch (const std::exception& e) {
+                error = e.what();
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename Record, char Delimiter, typename... Fields>
+class RecordSchema {
+    private:
+        typedef std::tuple<Fields...> FieldList;
+
+        template <size_t First, size_t Last, size_t... Index>
+        static bool readRange(const std::string& line, const FieldSpan* spans, Record& record, std::string& error,
+                              std::index_sequence<Index...>) {
+            // Left to right, stopping at the first failure; fields outside the range fold away
+            return ((Index < First || Index >= Last
+                     || std::tuple_element<Index, FieldList>::type::read(line, spans[Index], record, error)) && ...);
+        }
+
+    public:
+        typedef Record RecordType;
+        static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+        static constexpr char DELIMITER = Delimiter;
+
+        // Finds the fields split(line, Delimiter) would return without building
+        // them: a trailing delimiter does not start an empty last field. Returns
+        // the field count; only the first FIELD_COUNT spans are recorded
+        static size_t split(const std::string& line, FieldSpan (&spans)[FIELD_COUNT]) {
+            size_t count = 0;
+            size_t start = 0;
+            while (start < line.size()) {
+                size_t delimiter = line.find(Delimiter, start);
+                size_t stop = delimiter == std::string::npos ? line.size() : delimiter;
+                if (count < FIELD_COUNT) {
+                    size_t first = line.find_first_not_of(" \t\r\n", start);
+                    if (first >= stop) {
+                        spans[count] = {stop, stop};
+                    } else {
+                        spans[count] = {first, line.find_last_not_of(" \t\r\n", stop - 1) + 1};
+                    }
+                }
+                count++;
+                if (delimiter == std::string::npos) {
+                    break;
+                }
+                start = delimiter + 1;
+            }
+            return count;
+        }
+
+        // Converts and validates fields [First, Last) of a split line, so a
+        // reader can act between fields (e.g. filter on the key first)
+        template <size_t First = 0, size_t Last = FIELD_COUNT>
+        static bool readFields(const std::string& line, const FieldSpan (&spans)[FIELD_COUNT], Record& record,
+                               std::string& error) {
+            static_assert(First <= Last && Last <= FIELD_COUNT, "field range outside the schema");
+            return readRange<First, Last>(line, spans, record, error, std::make_index_sequence<FIELD_COUNT>());
+        }
+
+        // The whole line; fieldCount is set even when the count is wrong
+        static RecordParseStatus parse(const std::string& line, Record& record, size_t& fieldCount, std::string& error) {
+            FieldSpan spans[FIELD_COUNT];
+            fieldCount = split(line, spans);
+            if (fieldCount != FIELD_COUNT) {
+                return RECORD_BAD_FORMAT;
+            }
+            return readFields(line, spans, record, error) ? RECORD_PARSED : RECORD_BAD_VALUE;
+        }
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include "rowindex.h"
+#include "exceptions.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+extern std::string trim(const std::string&);
+
+RowIndex::RowIndex(const std::string& source)
+    : sourceName(source), indexName(source + ".idx"), rowCount(0), skippedCount(0) {}
+
+static void readSourceStats(const std::string& source, RowIndexHeader& header) {
+    header.sourceSize = std::filesystem::file_size(source);
+    header.sourceTime = std::filesystem::last_write_time(source).time_since_epoch().count();
+}
+
+bool RowIndex::isFresh() const {
+    std::ifstream in(indexName, std::ios::binary);
+    RowIndexHeader header;
+    if (!in.is_open() || !in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    RowIndexHeader current;
+    readSourceStats(sourceName, current);
+    uint64_t expectedSize = sizeof(header) + header.rowCount * sizeof(RowIndexEntry);
+    std::error_code error;
+    return std::memcmp(header.magic, ROW_INDEX_MAGIC, sizeof(header.magic)) == 0
+        && header.version == ROW_INDEX_VERSION
+        && header.sourceSize == current.sourceSize
+        && header.sourceTime == current.sourceTime
+        && std::filesystem::file_size(indexName, error) == expectedSize;
+}
+
+// One pass over the source; blank lines are counted but not indexed
+void RowIndex::build() {
+    std::ifstream in(sourceName, std::ios::binary);
+    if (!in.is_open()) {
+        throw FileAccessException(sourceName);
+    }
+
+    RowIndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ROW_INDEX_MAGIC, sizeof(header.magic));
+    header.version = ROW_INDEX_VERSION;
+    readSourceStats(sourceName, header);
+
+    std::vector<RowIndexEntry> entries;
+    std::string line;
+    uint64_t offset = 0;
+    uint32_t lineNumber = 0;
+    skippedCount = 0;
+    while (std::getline(in, line)) {
+        uint64_t rowOffset = offset;
+        offset += line.size() + (in.eof() ? 0 : 1);
+        lineNumber++;
+        if (line.find_first_not_of(" \t\r\n") == std::string::npos) {
+            continue;
+        }
+        std::string key = trim(line.substr(0, line.find(',')));
+        if (key.empty() || key.size() >= sizeof(RowIndexEntry::key)) {
+            skippedCount++;
+            continue;
+        }
+        RowIndexEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.key, key.data(), key.size());
+        entry.offset = rowOffset;
+        entry.lineNumber = lineNumber;
+        entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const RowIndexEntry& a, const RowIndexEntry& b) {
+        int order = std::strncmp(a.key, b.key, sizeof(a.key));
+        return order != 0 ? order < 0 : a.offset < b.offset;
+    });
+    header.rowCount = entries.size();
+
+    // Written beside the source and renamed into place, so readers never see half an index
+    std::string temporary = indexName + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(temporary);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(RowIndexEntry));
+    out.close();
+    if (!out || std::rename(temporary.c_str(), indexName.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw FileAccessException(indexName);
+    }
+    rowCount = header.rowCount;
+}
+
+bool RowIndex::open() {
+    FileExceptionCheck(sourceName);
+    if (isFresh()) {
+        std::ifstream in(indexName, std::ios::binary);
+        RowIndexHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        rowCount = header.rowCount;
+        return false;
+    }
+    std::cout << "Building row index " << indexName << std::endl;
+    build();
+    return true;
+}
+
+std::vector<RowIndexEntry> RowIndex::find(const std::string& studentID) const {
+    std::vector<RowIndexEntry> rows;
+    if (studentID.empty() || studentID.size() >= sizeof(RowIndexEntry::key)) {
+        return rows;
+    }
+    std::ifstream in(indexName, std::ios::binary);
+    if (!in.is_open()) {
+        throw FileAccessException(indexName);
+    }
+
+    // Lower bound over the on-disk entries, then read forward while the key matches
+    RowIndexEntry entry;
+    uint64_t low = 0, high = rowCount;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        in.seekg(sizeof(RowIndexHeader) + mid * sizeof(entry));
+        if (!in.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+            throw FileAccessException(indexName);
+        }
+        if (std::strncmp(entry.key, studentID.c_str(), sizeof(entry.key)) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    in.seekg(sizeof(RowIndexHeader) + low * sizeof(entry));
+    for (uint64_t i = low; i < rowCount && in.read(reinterpret_cast<char*>(&entry), sizeof(entry)); ++i) {
+        if (std::strncmp(entry.key, studentID.c_str(), sizeof(entry.key)) != 0) {
+            break;
+        }
+        rows.push_back(entry);
+    }
+    return rows;
+}
+
+std::string RowIndex::getIndexName() const {
+    return indexName;
+}
+
+uint64_t RowIndex::getRowCount() const {
+    return rowCount;
+}
+
+size_t RowIndex::getSkippedCount() const {
+    return skippedCount;
+}
@@ -0,0 +1,59 @@
+#ifndef ROWINDEX_H
+#define ROWINDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Sidecar index over a NameFile/CourseFile: for every row, the student ID in
+// its first field, the row's byte offset and its line number. It lives next
+// to the source as "<file>.idx", is rebuilt when the source's size or mtime
+// no longer match, and is searched with a handful of seeks, so a lookup
+// costs the same however large the source is.
+//
+//  [RowIndexHeader][RowIndexEntry x rowCount, sorted by key then offset]
+
+const char ROW_INDEX_MAGIC[8] = {'C', 'P', '3', '1', '7', 'I', 'D', 'X'};
+const uint32_t ROW_INDEX_VERSION = 1;
+
+struct RowIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint64_t rowCount;
+};
+
+struct RowIndexEntry {
+    char key[16];           // student ID, zero padded; longer IDs are not indexed
+    uint64_t offset;
+    uint32_t lineNumber;
+    uint32_t reserved;
+};
+
+class RowIndex {
+    private:
+        std::string sourceName;
+        std::string indexName;
+        uint64_t rowCount;
+        size_t skippedCount;
+
+        bool isFresh() const;
+        void build();
+
+    public:
+        RowIndex(const std::string& source);
+
+        // Uses the sidecar if it is current, otherwise rebuilds it; returns true if rebuilt
+        bool open();
+
+        // Rows for one student in file order
+        std::vector<RowIndexEntry> find(const std::string& studentID) const;
+
+        std::string getIndexName() const;
+        uint64_t getRowCount() const;
+        size_t getSkippedCount() const;
+};
+
+#endif
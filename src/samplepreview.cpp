@@ -0,0 +1,252 @@
+#include "samplepreview.h"
+#include "filereader.h"
+#include "student.h"
+#include "course.h"
+#include "exceptions.h"
+#include "bulkvalidation.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+
+static const double Z_95 = 1.96;
+
+// Files up to this many bytes per requested row are read whole
+static const uintmax_t EXACT_BYTES_PER_ROW = 128;
+
+SamplePreview::SamplePreview(size_t rows, unsigned seed)
+    : sampleSize(rows < 1 ? 1 : rows), blockLines(8), random(seed),
+      names(), courses(), nameRejected(0), courseRejected(0) {}
+
+static bool isBlank(const std::string& line) {
+    return line.find_first_not_of(" \t\r\n") == std::string::npos;
+}
+
+bool SamplePreview::sampleFile(const std::string& filename, FileSample& sample) {
+    FileExceptionCheck(filename);
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    sample.lines.clear();
+    sample.fileSize = std::filesystem::file_size(filename);
+    sample.exact = sample.fileSize <= sampleSize * EXACT_BYTES_PER_ROW;
+
+    std::string line;
+    if (sample.exact) {
+        while (std::getline(file, line)) {
+            if (!isBlank(line)) {
+                sample.lines.push_back(line);
+            }
+        }
+        sample.estimatedRows = sample.lines.size();
+        return true;
+    }
+
+    // Seek to sorted random offsets, drop the partial line, keep the next
+    // few; a block that starts inside the previous one continues after it
+    size_t blocks = (sampleSize + blockLines - 1) / blockLines;
+    std::uniform_int_distribution<uintmax_t> offsetDistribution(0, sample.fileSize - 1);
+    std::vector<uintmax_t> offsets(blocks);
+    for (auto& offset : offsets) {
+        offset = offsetDistribution(random);
+    }
+    std::sort(offsets.begin(), offsets.end());
+
+    uintmax_t bytes = 0;
+    uintmax_t previousEnd = 0;
+    for (uintmax_t offset : offsets) {
+        file.clear();
+        if (offset < previousEnd) {
+            file.seekg(previousEnd);
+        } else {
+            file.seekg(offset);
+            if (offset > 0) {
+                std::getline(file, line);
+            }
+        }
+        for (size_t taken = 0; taken < blockLines && std::getline(file, line); ) {
+            if (!isBlank(line)) {
+                sample.lines.push_back(line);
+                bytes += line.size() + 1;
+                taken++;
+            }
+        }
+        if (!file) {
+            previousEnd = sample.fileSize;
+            continue;
+        }
+        previousEnd = file.tellg();
+    }
+
+    sample.estimatedRows = sample.lines.empty() ? 0.0
+                         : sample.fileSize / (static_cast<double>(bytes) / sample.lines.size());
+    return true;
+}
+
+// Same checks readNextStudent applies, through the quiet validator so
+// sampled rows are not reported one by one
+void SamplePreview::analyzeNames() {
+    nameRejected = 0;
+    NameRecord record;
+    size_t fieldCount;
+    std::string error;
+    for (const auto& line : names.lines) {
+        try {
+            if (NameFileSchema::parse(line, record, fieldCount, error) != RECORD_PARSED
+                || record.studentID.empty() || record.studentName.empty()) {
+                nameRejected++;
+                continue;
+            }
+            Student student;
+            student.setStudentID(record.studentID);
+            student.setStudentName(record.studentName);
+            ValidStudentExceptionCheck(student, true);
+        } catch (const std::exception&) {
+            nameRejected++;
+        }
+    }
+}
+
+// Same parser as readCourseFile, then the bulk validator, which rejects
+// exactly what the Course constructor would without reporting each row
+void SamplePreview::analyzeCourses() {
+    FileReader parser;
+    std::vector<CourseRecord> parsed;
+    CourseRecord record;
+    courseRejected = 0;
+    courseGrades.clear();
+    studentRows.clear();
+    for (const auto& line : courses.lines) {
+        parser.parseCourseLine(line, 0, record);
+        if (record.status != COURSE_RECORD_PARSED) {
+            courseRejected++;
+            continue;
+        }
+        parsed.push_back(record);
+    }
+
+    BulkValidator validator;
+    validator.resize(parsed.size());
+    for (size_t r = 0; r < parsed.size(); ++r) {
+        const CourseRecord& row = parsed[r];
+        validator.setRow(r, row.courseCode, row.test1, row.test2, row.test3, row.finalExam);
+    }
+    validator.validate();
+    courseRejected += validator.getRejectedCount();
+
+    for (size_t r = 0; r < parsed.size(); ++r) {
+        if (validator.isRejected(r)) {
+            continue;
+        }
+        const CourseRecord& row = parsed[r];
+        Course course = Course::createValidated(row.courseCode, row.test1, row.test2, row.test3, row.finalExam);
+        double grade = course.calculateFinalGrade();
+        CourseSampleStats& stats = courseGrades[row.courseCode];
+        stats.rows++;
+        stats.sum += grade;
+        stats.sumSquares += grade * grade;
+        studentRows[row.studentID]++;
+    }
+}
+
+bool SamplePreview::run(const std::string& nameFile, const std::string& courseFile) {
+    if (!sampleFile(nameFile, names) || !sampleFile(courseFile, courses)) {
+        return false;
+    }
+    analyzeNames();
+    analyzeCourses();
+    return true;
+}
+
+static void printFileSummary(const std::string& label, const FileSample& sample, const PreviewEstimate& rejectRate) {
+    std::cout << label << ": " << (sample.exact ? "" : "~") << std::llround(sample.estimatedRows) << " rows ("
+              << sample.lines.size() << (sample.exact ? " read, whole file)" : " sampled)") << std::endl;
+    std::cout << "  Rejected rows: " << rejectRate.value * 100.0 << "% ± " << rejectRate.margin * 100.0
+              << "% (~" << std::llround(rejectRate.value * sample.estimatedRows) << " rows)" << std::endl;
+}
+
+void SamplePreview::printReport() const {
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::cout << "=== Preview (95% confidence intervals) ===" << std::endl;
+    printFileSummary("NameFile.txt", names, getNameRejectRate());
+    printFileSummary("CourseFile.txt", courses, getCourseRejectRate());
+
+    // Most-sampled courses first; a single row gives no interval
+    std::vector<std::pair<std::string, CourseSampleStats>> ranked(courseGrades.begin(), courseGrades.end());
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.second.rows != b.second.rows ? a.second.rows > b.second.rows : a.first < b.first;
+    });
+    std::cout << "Per-course final grade (" << ranked.size() << " courses seen):" << std::endl;
+    for (size_t i = 0; i < ranked.size() && i < 20; ++i) {
+        PreviewEstimate average = getCourseAverage(ranked[i].first);
+        std::cout << "  " << std::left << std::setw(8) << ranked[i].first << std::right
+                  << average.value << " ± " << average.margin << "  (n=" << ranked[i].second.rows << ")" << std::endl;
+    }
+
+    std::vector<std::pair<std::string, size_t>> busiest(studentRows.begin(), studentRows.end());
+    std::sort(busiest.begin(), busiest.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    std::cout << "Students with the most courses in the sample:" << std::endl;
+    for (size_t i = 0; i < busiest.size() && i < 5; ++i) {
+        std::cout << "  " << busiest[i].first << "  " << busiest[i].second << " courses" << std::endl;
+    }
+    if (names.estimatedRows > 0) {
+        std::cout << "Courses per student: ~" << courses.estimatedRows / names.estimatedRows << std::endl;
+    }
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+const FileSample& SamplePreview::getNameSample() const {
+    return names;
+}
+
+const FileSample& SamplePreview::getCourseSample() const {
+    return courses;
+}
+
+PreviewEstimate SamplePreview::getNameRejectRate() const {
+    return proportion(nameRejected, names.lines.size(), names.exact);
+}
+
+PreviewEstimate SamplePreview::getCourseRejectRate() const {
+    return proportion(courseRejected, courses.lines.size(), courses.exact);
+}
+
+PreviewEstimate SamplePreview::getCourseAverage(const std::string& courseCode) const {
+    auto it = courseGrades.find(courseCode);
+    if (it == courseGrades.end()) {
+        return PreviewEstimate{0.0, 0.0};
+    }
+    return mean(it->second.sum, it->second.sumSquares, it->second.rows, courses.exact);
+}
+
+// Normal approximation to the binomial
+PreviewEstimate SamplePreview::proportion(size_t hits, size_t rows, bool exact) {
+    if (rows == 0) {
+        return PreviewEstimate{0.0, 0.0};
+    }
+    double p = static_cast<double>(hits) / rows;
+    return PreviewEstimate{p, exact ? 0.0 : Z_95 * std::sqrt(p * (1.0 - p) / rows)};
+}
+
+PreviewEstimate SamplePreview::mean(double sum, double sumSquares, size_t rows, bool exact) {
+    if (rows == 0) {
+        return PreviewEstimate{0.0, 0.0};
+    }
+    double average = sum / rows;
+    if (exact || rows < 2) {
+        return PreviewEstimate{average, 0.0};
+    }
+    double variance = std::max(0.0, (sumSquares - rows * average * average) / (rows - 1));
+    return PreviewEstimate{average, Z_95 * std::sqrt(variance / rows)};
+}
@@ -0,0 +1,67 @@
+#ifndef SAMPLEPREVIEW_H
+#define SAMPLEPREVIEW_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <cstdint>
+
+// value ± margin at 95% confidence; margin is 0 when the whole file was read
+struct PreviewEstimate {
+    double value;
+    double margin;
+};
+
+// Rows drawn from one input file
+struct FileSample {
+    std::vector<std::string> lines;
+    uintmax_t fileSize;
+    double estimatedRows;
+    bool exact;                 // small file, every row was read
+};
+
+struct CourseSampleStats {
+    size_t rows;
+    double sum;
+    double sumSquares;
+};
+
+// Approximate report on a new feed without loading it. Rows are read in
+// short blocks after random seeks, so the run time follows the sample size
+// rather than the file size. Sampled rows go through the same parser and
+// validators as a full load.
+class SamplePreview {
+    private:
+        size_t sampleSize;
+        size_t blockLines;
+        std::mt19937_64 random;
+
+        FileSample names;
+        FileSample courses;
+        size_t nameRejected;
+        size_t courseRejected;
+        std::map<std::string, CourseSampleStats> courseGrades;
+        std::map<std::string, size_t> studentRows;
+
+        bool sampleFile(const std::string& filename, FileSample& sample);
+        void analyzeNames();
+        void analyzeCourses();
+
+    public:
+        SamplePreview(size_t rows, unsigned seed = 317);
+
+        bool run(const std::string& nameFile, const std::string& courseFile);
+        void printReport() const;
+
+        const FileSample& getNameSample() const;
+        const FileSample& getCourseSample() const;
+        PreviewEstimate getNameRejectRate() const;
+        PreviewEstimate getCourseRejectRate() const;
+        PreviewEstimate getCourseAverage(const std::string& courseCode) const;
+
+        static PreviewEstimate proportion(size_t hits, size_t rows, bool exact);
+        static PreviewEstimate mean(double sum, double sumSquares, size_t rows, bool exact);
+};
+
+#endif
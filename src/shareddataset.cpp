@@ -0,0 +1,312 @@
+#include "shareddataset.h"
+#include "exceptions.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "control segment needs lock-free 64-bit atomics");
+
+static std::string segmentName(const std::string& name, uint64_t generation) {
+    return name + "." + std::to_string(generation);
+}
+
+#ifndef _WIN32
+
+// Maps the control segment, creating and initializing it if needed
+static SharedControl* openControl(const std::string& name, bool create) {
+    int fd = shm_open(name.c_str(), create ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0) {
+        throw SharedMemoryException("cannot open " + name + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (info.st_size == 0 && create && ftruncate(fd, sizeof(SharedControl)) != 0)) {
+        close(fd);
+        throw SharedMemoryException("cannot size " + name);
+    }
+    if (!create && static_cast<size_t>(info.st_size) < sizeof(SharedControl)) {
+        close(fd);
+        throw SharedMemoryException(name + " is not initialized");
+    }
+    void* address = mmap(nullptr, sizeof(SharedControl), create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        throw SharedMemoryException("cannot map " + name);
+    }
+
+    // A new segment is zero-filled, which is also a valid pair of atomics
+    SharedControl* control = static_cast<SharedControl*>(address);
+    if (create && std::memcmp(control->magic, SHARED_DATASET_MAGIC, sizeof(control->magic)) != 0) {
+        std::memcpy(control->magic, SHARED_DATASET_MAGIC, sizeof(control->magic));
+    }
+    if (std::memcmp(control->magic, SHARED_DATASET_MAGIC, sizeof(control->magic)) != 0) {
+        munmap(address, sizeof(SharedControl));
+        throw SharedMemoryException(name + " is not a dataset control segment");
+    }
+    return control;
+}
+
+uint64_t publishSharedDataset(const std::string& name, const std::map<std::string, Student>& students) {
+    uint64_t courseCount = 0, stringBytes = 0;
+    for (const auto& [id, student] : students) {
+        courseCount += student.getCourseCount();
+        stringBytes += student.getStudentID().size() + student.getStudentName().size();
+        for (const auto& course : student.getCourses()) {
+            stringBytes += course.getCourseCode().size();
+        }
+    }
+
+    SharedDatasetHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SHARED_DATASET_MAGIC, sizeof(header.magic));
+    header.version = SHARED_DATASET_VERSION;
+    header.studentCount = students.size();
+    header.courseCount = courseCount;
+    header.studentsOffset = sizeof(SharedDatasetHeader);
+    header.coursesOffset = header.studentsOffset + students.size() * sizeof(SharedStudent);
+    header.stringsOffset = header.coursesOffset + courseCount * sizeof(SharedCourse);
+    header.totalSize = header.stringsOffset + stringBytes;
+
+    SharedControl* control = openControl(name, true);
+    header.generation = control->next.fetch_add(1) + 1;
+    std::string segment = segmentName(name, header.generation);
+
+    int fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0 || ftruncate(fd, header.totalSize) != 0) {
+        if (fd >= 0) {
+            close(fd);
+            shm_unlink(segment.c_str());
+        }
+        munmap(control, sizeof(SharedControl));
+        throw SharedMemoryException("cannot create " + segment + ": " + std::strerror(errno));
+    }
+    void* address = mmap(nullptr, header.totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        shm_unlink(segment.c_str());
+        munmap(control, sizeof(SharedControl));
+        throw SharedMemoryException("cannot map " + segment);
+    }
+
+    unsigned char* base = static_cast<unsigned char*>(address);
+    SharedStudent* sharedStudents = reinterpret_cast<SharedStudent*>(base + header.studentsOffset);
+    SharedCourse* sharedCourses = reinterpret_cast<SharedCourse*>(base + header.coursesOffset);
+    uint64_t stringEnd = header.stringsOffset;
+    auto store = [&](const std::string& text) {
+        SharedString reference = {stringEnd, static_cast<uint32_t>(text.size()), 0};
+        std::memcpy(base + stringEnd, text.data(), text.size());
+        stringEnd += text.size();
+        return reference;
+    };
+
+    size_t s = 0, c = 0;
+    for (const auto& [id, student] : students) {
+        sharedStudents[s].id = store(student.getStudentID());
+        sharedStudents[s].name = store(student.getStudentName());
+        sharedStudents[s].firstCourse = c;
+        sharedStudents[s].courseCount = student.getCourseCount();
+        for (const auto& course : student.getCourses()) {
+            sharedCourses[c].code = store(course.getCourseCode());
+            sharedCourses[c].test1 = course.getTest1();
+            sharedCourses[c].test2 = course.getTest2();
+            sharedCourses[c].test3 = course.getTest3();
+            sharedCourses[c].finalExam = course.getFinalExam();
+            c++;
+        }
+        s++;
+    }
+    // The header goes in last; the segment only becomes visible below anyway
+    std::memcpy(base, &header, sizeof(header));
+    munmap(address, header.totalSize);
+
+    // Only move forward: a publisher that took a later generation may have finished first
+    uint64_t previous = control->current.load(std::memory_order_acquire);
+    while (previous < header.generation
+           && !control->current.compare_exchange_weak(previous, header.generation, std::memory_order_acq_rel,
+                                                      std::memory_order_acquire)) {
+    }
+    if (previous > header.generation) {
+        shm_unlink(segment.c_str());
+    } else if (previous != 0) {
+        shm_unlink(segmentName(name, previous).c_str());
+    }
+    munmap(control, sizeof(SharedControl));
+    return header.generation;
+}
+
+void unlinkSharedDataset(const std::string& name) {
+    SharedControl* control = openControl(name, false);
+    uint64_t current = control->current.load(std::memory_order_acquire);
+    munmap(control, sizeof(SharedControl));
+    if (current != 0) {
+        shm_unlink(segmentName(name, current).c_str());
+    }
+    shm_unlink(name.c_str());
+}
+
+SharedDatasetView::SharedDatasetView(const std::string& name) : base(nullptr), size(0), header(nullptr) {
+    SharedControl* control = openControl(name, false);
+
+    // A reload can unlink the generation just read; read it again and retry
+    for (int attempt = 0; attempt < 5 && !base; ++attempt) {
+        uint64_t generation = control->current.load(std::memory_order_acquire);
+        if (generation == 0) {
+            break;
+        }
+        int fd = shm_open(segmentName(name, generation).c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            continue;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedDatasetHeader)) {
+            close(fd);
+            continue;
+        }
+        void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            continue;
+        }
+        base = static_cast<const unsigned char*>(address);
+        size = info.st_size;
+        header = reinterpret_cast<const SharedDatasetHeader*>(base);
+        if (header->generation != generation) {
+            munmap(address, size);
+            base = nullptr;
+        }
+    }
+    munmap(control, sizeof(SharedControl));
+    if (!base) {
+        throw SharedMemoryException("no dataset published under " + name);
+    }
+
+    if (!validateLayout()) {
+        munmap(const_cast<unsigned char*>(base), size);
+        throw SharedMemoryException(name + " has an unsupported or damaged layout");
+    }
+}
+
+SharedDatasetView::~SharedDatasetView() {
+    munmap(const_cast<unsigned char*>(base), size);
+}
+
+#else
+
+uint64_t publishSharedDataset(const std::string&, const std::map<std::string, Student>&) {
+    throw SharedMemoryException("POSIX shared memory is not available on this platform");
+}
+
+void unlinkSharedDataset(const std::string&) {
+    throw SharedMemoryException("POSIX shared memory is not available on this platform");
+}
+
+SharedDatasetView::SharedDatasetView(const std::string&) : base(nullptr), size(0), header(nullptr) {
+    throw SharedMemoryException("POSIX shared memory is not available on this platform");
+}
+
+SharedDatasetView::~SharedDatasetView() {}
+
+#endif
+
+bool SharedDatasetView::stringInBounds(const SharedString& text) const {
+    return text.offset >= header->stringsOffset && text.offset <= size && text.length <= size - text.offset;
+}
+
+bool SharedDatasetView::validateLayout() const {
+    // Counts are bounded by the segment size first, so the offset sums below cannot overflow
+    if (std::memcmp(header->magic, SHARED_DATASET_MAGIC, sizeof(header->magic)) != 0
+        || header->version != SHARED_DATASET_VERSION
+        || header->totalSize != size
+        || header->studentCount > size / sizeof(SharedStudent)
+        || header->courseCount > size / sizeof(SharedCourse)
+        || header->studentsOffset != sizeof(SharedDatasetHeader)
+        || header->coursesOffset != header->studentsOffset + header->studentCount * sizeof(SharedStudent)
+        || header->stringsOffset != header->coursesOffset + header->courseCount * sizeof(SharedCourse)
+        || header->stringsOffset > size) {
+        return false;
+    }
+
+    std::string_view previousID;
+    for (size_t i = 0; i < header->studentCount; ++i) {
+        const SharedStudent& student = studentAt(i);
+        if (!stringInBounds(student.id) || !stringInBounds(student.name)
+            || student.firstCourse > header->courseCount
+            || student.courseCount > header->courseCount - student.firstCourse) {
+            return false;
+        }
+        std::string_view id = stringAt(student.id);
+        if (i > 0 && !(previousID < id)) {
+            return false;
+        }
+        previousID = id;
+    }
+    for (size_t i = 0; i < header->courseCount; ++i) {
+        if (!stringInBounds(courseAt(i).code)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view SharedDatasetView::stringAt(const SharedString& text) const {
+    return std::string_view(reinterpret_cast<const char*>(base + text.offset), text.length);
+}
+
+uint64_t SharedDatasetView::getGeneration() const {
+    return header->generation;
+}
+
+size_t SharedDatasetView::getStudentCount() const {
+    return header->studentCount;
+}
+
+size_t SharedDatasetView::getCourseCount() const {
+    return header->courseCount;
+}
+
+size_t SharedDatasetView::getSize() const {
+    return size;
+}
+
+const SharedStudent& SharedDatasetView::studentAt(size_t index) const {
+    return reinterpret_cast<const SharedStudent*>(base + header->studentsOffset)[index];
+}
+
+const SharedCourse& SharedDatasetView::courseAt(size_t index) const {
+    return reinterpret_cast<const SharedCourse*>(base + header->coursesOffset)[index];
+}
+
+std::string_view SharedDatasetView::studentID(const SharedStudent& student) const {
+    return stringAt(student.id);
+}
+
+std::string_view SharedDatasetView::studentName(const SharedStudent& student) const {
+    return stringAt(student.name);
+}
+
+std::string_view SharedDatasetView::courseCode(const SharedCourse& course) const {
+    return stringAt(course.code);
+}
+
+Course SharedDatasetView::makeCourse(const SharedCourse& course) const {
+    return Course::createValidated(std::string(courseCode(course)), course.test1, course.test2,
+                                   course.test3, course.finalExam);
+}
+
+const SharedStudent* SharedDatasetView::findStudent(std::string_view studentID) const {
+    if (header->studentCount == 0) {
+        return nullptr;
+    }
+    const SharedStudent* first = &studentAt(0);
+    const SharedStudent* last = first + header->studentCount;
+    const SharedStudent* it = std::lower_bound(first, last, studentID,
+        [this](const SharedStudent& student, std::string_view id) {
+            return stringAt(student.id) < id;
+        });
+    return (it != last && stringAt(it->id) == studentID) ? it : nullptr;
+}
@@ -0,0 +1,114 @@
+#ifndef SHAREDDATASET_H
+#define SHAREDDATASET_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <map>
+#include <atomic>
+#include "student.h"
+#include "course.h"
+
+// A loaded dataset in named POSIX shared memory, so several report
+// processes on one host share a single copy without parsing.
+//
+// Each publish writes a complete data segment "<name>.<generation>" and only
+// then stores that generation in the control segment "<name>". Readers load
+// the generation first and open the matching data segment, so they never
+// see a half-built dataset; a reload unlinks the old segment, and readers
+// still attached to it keep their mapping until they detach. The current
+// generation only moves forward, so of two concurrent publishers the later
+// generation wins.
+//
+// Data segment layout; every reference is a byte offset from the segment
+// start, so the mapping address does not matter:
+//
+//  [SharedDatasetHeader][SharedStudent x studentCount][SharedCourse x courseCount][string bytes]
+
+const char SHARED_DATASET_MAGIC[8] = {'C', 'P', '3', '1', '7', 'S', 'H', 'M'};
+const uint32_t SHARED_DATASET_VERSION = 1;
+
+struct SharedControl {
+    char magic[8];
+    std::atomic<uint64_t> current;      // generation readers should attach to; 0 = none yet
+    std::atomic<uint64_t> next;         // last generation handed to a publisher
+};
+
+struct SharedDatasetHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t generation;
+    uint64_t totalSize;
+    uint64_t studentCount;
+    uint64_t courseCount;
+    uint64_t studentsOffset;
+    uint64_t coursesOffset;
+    uint64_t stringsOffset;
+};
+
+struct SharedString {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t reserved;
+};
+
+// Students are sorted by ID; their courses are contiguous
+struct SharedStudent {
+    SharedString id;
+    SharedString name;
+    uint64_t firstCourse;
+    uint64_t courseCount;
+};
+
+struct SharedCourse {
+    SharedString code;
+    float test1, test2, test3, finalExam;
+};
+
+// Writes the students as a new generation and makes it current unless a concurrent
+// publisher already made a later one current; returns the generation written
+uint64_t publishSharedDataset(const std::string& name, const std::map<std::string, Student>& students);
+
+// Removes the control segment and the current data segment
+void unlinkSharedDataset(const std::string& name);
+
+// Read-only attachment to the current generation. Every record is checked on
+// attach; throws SharedMemoryException for a damaged segment
+class SharedDatasetView {
+    private:
+        const unsigned char* base;
+        size_t size;
+        const SharedDatasetHeader* header;
+
+        std::string_view stringAt(const SharedString& text) const;
+        bool stringInBounds(const SharedString& text) const;
+        // Every offset and count in range and the IDs sorted, so no accessor can leave the mapping
+        bool validateLayout() const;
+
+    public:
+        SharedDatasetView(const std::string& name);
+        ~SharedDatasetView();
+
+        SharedDatasetView(const SharedDatasetView&) = delete;
+        SharedDatasetView& operator=(const SharedDatasetView&) = delete;
+
+        uint64_t getGeneration() const;
+        size_t getStudentCount() const;
+        size_t getCourseCount() const;
+        size_t getSize() const;
+
+        const SharedStudent& studentAt(size_t index) const;
+        const SharedCourse& courseAt(size_t index) const;
+        std::string_view studentID(const SharedStudent& student) const;
+        std::string_view studentName(const SharedStudent& student) const;
+        std::string_view courseCode(const SharedCourse& course) const;
+
+        // A Course with the stored grades, for the usual grade calculations
+        Course makeCourse(const SharedCourse& course) const;
+
+        // Binary search by ID; nullptr if absent
+        const SharedStudent* findStudent(std::string_view studentID) const;
+};
+
+#endif
@@ -0,0 +1,205 @@
+#include "stageprofiler.h"
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const size_t NO_STAGE = static_cast<size_t>(-1);
+
+#ifdef __linux__
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} COUNTER_EVENTS[PROFILE_COUNTER_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+static std::string describeFailure(int error) {
+    switch (error) {
+        case EACCES:
+        case EPERM:
+            return "not permitted (perf_event_paranoid or the container's seccomp profile)";
+        case ENOENT:
+        case EOPNOTSUPP:
+            return "not supported on this host (no PMU, as in most VMs and containers)";
+        case ENOSYS:
+            return "perf_event_open is not available";
+        default:
+            return std::strerror(error);
+    }
+}
+
+StageProfiler::StageProfiler() : current(NO_STAGE) {
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = COUNTER_EVENTS[i].type;
+        attributes.config = COUNTER_EVENTS[i].config;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.exclude_kernel = 1;      // allowed at the default paranoid level
+        attributes.exclude_hv = 1;
+        attributes.inherit = 1;             // writer threads are added in when they exit
+        descriptors[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        if (descriptors[i] < 0 && unavailableReason.empty()) {
+            unavailableReason = describeFailure(errno);
+        }
+    }
+}
+
+StageProfiler::~StageProfiler() {
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        if (descriptors[i] >= 0) {
+            close(descriptors[i]);
+        }
+    }
+}
+
+bool StageProfiler::read(int counter, Reading& reading) const {
+    return descriptors[counter] >= 0
+        && ::read(descriptors[counter], &reading, sizeof(reading)) == static_cast<ssize_t>(sizeof(reading));
+}
+
+#else
+
+StageProfiler::StageProfiler() : unavailableReason("perf_event_open is Linux only"), current(NO_STAGE) {
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        descriptors[i] = -1;
+    }
+}
+
+StageProfiler::~StageProfiler() {}
+
+bool StageProfiler::read(int, Reading&) const {
+    return false;
+}
+
+#endif
+
+void StageProfiler::begin(const std::string& stage) {
+    current = stages.size();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (stages[i].name == stage) {
+            current = i;
+        }
+    }
+    if (current == stages.size()) {
+        StageProfile profile = StageProfile();
+        profile.name = stage;
+        stages.push_back(profile);
+    }
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        if (!read(i, startReadings[i])) {
+            startReadings[i] = Reading();
+        }
+    }
+    started = std::chrono::steady_clock::now();
+}
+
+void StageProfiler::end(size_t rows) {
+    std::chrono::steady_clock::time_point stopped = std::chrono::steady_clock::now();
+    if (current == NO_STAGE) {
+        return;
+    }
+    StageProfile& profile = stages[current];
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        Reading reading;
+        if (!read(i, reading)) {
+            continue;
+        }
+        // Scaled up for the time the kernel had the counter switched out
+        uint64_t running = reading.running - startReadings[i].running;
+        uint64_t enabled = reading.enabled - startReadings[i].enabled;
+        if (running > 0) {
+            profile.counts[i] += static_cast<double>(reading.value - startReadings[i].value) * enabled / running;
+        }
+    }
+    profile.rows += rows;
+    profile.seconds += std::chrono::duration<double>(stopped - started).count();
+    current = NO_STAGE;
+}
+
+bool StageProfiler::hasCounter(ProfileCounter counter) const {
+    return descriptors[counter] >= 0;
+}
+
+bool StageProfiler::hasAnyCounter() const {
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        if (descriptors[i] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string& StageProfiler::getUnavailableReason() const {
+    return unavailableReason;
+}
+
+const std::vector<StageProfile>& StageProfiler::getStages() const {
+    return stages;
+}
+
+const char* StageProfiler::counterName(ProfileCounter counter) {
+    static const char* const NAMES[PROFILE_COUNTER_COUNT] = {
+        "cycles", "instructions", "cache-misses", "branch-misses", "page-faults"
+    };
+    return NAMES[counter];
+}
+
+void StageProfiler::printReport() const {
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << "=== Stage profile (per row) ===" << std::endl;
+    std::string missing;
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        if (!hasCounter(static_cast<ProfileCounter>(i))) {
+            missing += (missing.empty() ? "" : ", ") + std::string(counterName(static_cast<ProfileCounter>(i)));
+        }
+    }
+    if (!missing.empty()) {
+        std::cout << "Counters unavailable (" << missing << "): " << unavailableReason << std::endl;
+    }
+
+    std::cout << std::left << std::setw(18) << "stage" << std::right << std::setw(10) << "rows"
+              << std::setw(10) << "ns";
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+        std::cout << std::setw(15) << counterName(static_cast<ProfileCounter>(i));
+    }
+    std::cout << std::setw(7) << "IPC" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& stage : stages) {
+        double rows = stage.rows > 0 ? static_cast<double>(stage.rows) : 1.0;
+        std::cout << std::left << std::setw(18) << stage.name << std::right << std::setw(10) << stage.rows
+                  << std::setw(10) << stage.seconds * 1e9 / rows;
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i) {
+            if (hasCounter(static_cast<ProfileCounter>(i))) {
+                std::cout << std::setw(15) << stage.counts[i] / rows;
+            } else {
+                std::cout << std::setw(15) << "n/a";
+            }
+        }
+        bool ipc = hasCounter(PROFILE_CYCLES) && hasCounter(PROFILE_INSTRUCTIONS) && stage.counts[PROFILE_CYCLES] > 0;
+        if (ipc) {
+            std::cout << std::setw(7) << stage.counts[PROFILE_INSTRUCTIONS] / stage.counts[PROFILE_CYCLES];
+        } else {
+            std::cout << std::setw(7) << "n/a";
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
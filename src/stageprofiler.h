@@ -0,0 +1,71 @@
+#ifndef STAGEPROFILER_H
+#define STAGEPROFILER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+enum ProfileCounter {
+    PROFILE_CYCLES,
+    PROFILE_INSTRUCTIONS,
+    PROFILE_CACHE_MISSES,
+    PROFILE_BRANCH_MISSES,
+    PROFILE_PAGE_FAULTS,
+    PROFILE_COUNTER_COUNT
+};
+
+// Totals for one pipeline stage; a stage begun again adds to its entry
+struct StageProfile {
+    std::string name;
+    size_t rows;
+    double seconds;
+    double counts[PROFILE_COUNTER_COUNT];
+};
+
+// Per-stage hardware counters through Linux perf_event_open, counting this
+// thread in user space. Each counter is opened on its own, so a host that
+// lacks some (a VM without a PMU, a container whose seccomp profile or
+// perf_event_paranoid setting blocks them) still reports the rest, and wall
+// time is always reported. Counters the kernel multiplexes are scaled by
+// their enabled/running time.
+class StageProfiler {
+    private:
+        struct Reading {
+            uint64_t value;
+            uint64_t enabled;
+            uint64_t running;
+        };
+
+        int descriptors[PROFILE_COUNTER_COUNT];
+        std::string unavailableReason;
+        std::vector<StageProfile> stages;
+
+        size_t current;
+        std::chrono::steady_clock::time_point started;
+        Reading startReadings[PROFILE_COUNTER_COUNT];
+
+        bool read(int counter, Reading& reading) const;
+
+    public:
+        StageProfiler();
+        ~StageProfiler();
+
+        StageProfiler(const StageProfiler&) = delete;
+        StageProfiler& operator=(const StageProfiler&) = delete;
+
+        void begin(const std::string& stage);
+        void end(size_t rows);
+
+        bool hasCounter(ProfileCounter counter) const;
+        bool hasAnyCounter() const;
+        const std::string& getUnavailableReason() const;
+        const std::vector<StageProfile>& getStages() const;
+
+        // Per-row figures for every stage, "n/a" for missing counters
+        void printReport() const;
+
+        static const char* counterName(ProfileCounter counter);
+};
+
+#endif
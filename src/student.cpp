@@ -3,24 +3,47 @@
 #include <sstream>
 #include <iomanip>
 #include <cctype>
+#include <atomic>
 #include "exceptions.h"
 
+// Totals of the threads that have finished
+static std::atomic<unsigned long> finishedHits(0);
+static std::atomic<unsigned long> finishedMisses(0);
+
+// Counted per thread, as Course's final grade cache is
+struct StudentCacheCounts {
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+
+    ~StudentCacheCounts() {
+        finishedHits.fetch_add(hits, std::memory_order_relaxed);
+        finishedMisses.fetch_add(misses, std::memory_order_relaxed);
+    }
+};
+static thread_local StudentCacheCounts cacheCounts;
+
 // Default constructor
-Student::Student() : studentID(""), studentName("") {}
+Student::Student() : studentID(""), studentName(""), cachedAverage(0.0f), averageCached(false), cachedVersions(0) {}
 
 // Parameterized constructor
 Student::Student(const std::string& id, const std::string& name) 
-    : studentID(id), studentName(name) {
-    
-    // Sanitize the name
-    studentName = sanitizeName(name);
+    : studentID(id), studentName(sanitizeName(name)), cachedAverage(0.0f), averageCached(false), cachedVersions(0) {
 
     ValidStudentExceptionCheck(*this);
 }
 
 // Copy constructor
 Student::Student(const Student& other)
-    : studentID(other.studentID), studentName(other.studentName), courses(other.courses) {}
+    : studentID(other.studentID), studentName(other.studentName), courses(other.courses),
+      cachedAverage(0.0f), averageCached(false), cachedVersions(0) {
+    copyCache(other);
+}
+
+Student::Student(Student&& other) noexcept
+    : studentID(std::move(other.studentID)), studentName(std::move(other.studentName)),
+      courses(std::move(other.courses)), cachedAverage(0.0f), averageCached(false), cachedVersions(0) {
+    copyCache(other);
+}
 
 // Assignment operator
 Student& Student::operator=(const Student& other) {
@@ -28,10 +51,27 @@ Student& Student::operator=(const Student& other) {
         studentID = other.studentID;
         studentName = other.studentName;
         courses = other.courses;
+        copyCache(other);
+    }
+    return *this;
+}
+
+Student& Student::operator=(Student&& other) noexcept {
+    if (this != &other) {
+        studentID = std::move(other.studentID);
+        studentName = std::move(other.studentName);
+        courses = std::move(other.courses);
+        copyCache(other);
     }
     return *this;
 }
 
+void Student::copyCache(const Student& other) {
+    cachedAverage.store(other.cachedAverage.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    cachedVersions.store(other.cachedVersions.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    averageCached.store(other.averageCached.load(std::memory_order_acquire), std::memory_order_release);
+}
+
 std::string Student::sanitizeName(const std::string& name) const {
     std::string result = name;
     
@@ -54,15 +94,15 @@ std::string Student::sanitizeName(const std::string& name) const {
 }
 
 // Getters
-std::string Student::getStudentID() const {
+const std::string& Student::getStudentID() const {
     return studentID;
 }
 
-std::string Student::getStudentName() const {
+const std::string& Student::getStudentName() const {
     return studentName;
 }
 
-const std::vector<Course>& Student::getCourses() const {
+const Student::CourseList& Student::getCourses() const {
     return courses;
 }
 
@@ -87,11 +127,32 @@ void Student::setStudentName(const std::string& name) {
 
 // Course management
 bool Student::addCourse(const Course& course) {
-    courses.push_back(course);
+    return addCourse(Course(course));
+}
+
+bool Student::addCourse(Course&& course) {
+    if (courses.full())
+        throw CheckMaxCourses("Limit Reached for student (" + studentID + ")");
+    averageCached.store(false, std::memory_order_relaxed);
+    courses.push_back(std::move(course));
     CourseStudentExceptionCheck(*this);
     return true;   
 }
 
+bool Student::addValidatedCourse(const Course& course) {
+    return addValidatedCourse(Course(course));
+}
+
+// Grades were range-checked in bulk, so only the enrollment rules are checked here
+bool Student::addValidatedCourse(Course&& course) {
+    if (courses.full())
+        throw CheckMaxCourses("Limit Reached for student (" + studentID + ")");
+    averageCached.store(false, std::memory_order_relaxed);
+    courses.push_back(std::move(course));
+    CourseEnrollmentExceptionCheck(*this);
+    return true;
+}
+
 bool Student::removeCourse(const std::string& courseCode) {
     auto it = std::find_if(courses.begin(), courses.end(),
         [&courseCode](const Course& course) {
@@ -100,6 +161,7 @@ bool Student::removeCourse(const std::string& courseCode) {
     
     if (it != courses.end()) {
         courses.erase(it);
+        averageCached.store(false, std::memory_order_relaxed);
         return true;
     }
     
@@ -115,6 +177,8 @@ const Course* Student::findCourse(const std::string& courseCode) const {
     return (it != courses.end()) ? &(*it) : nullptr;
 }
 
+// Grades changed through the returned pointer raise the course's version,
+// which getOverallAverage checks
 Course* Student::findCourse(const std::string& courseCode) {
     auto it = std::find_if(courses.begin(), courses.end(),
         [&courseCode](const Course& course) {
@@ -133,13 +197,43 @@ float Student::getOverallAverage() const {
     if (courses.empty()) {
         return 0.0f;
     }
+
+    // Acquires pair with the releases below, so matching versions mean the average is visible
+    uint64_t versions = courseVersions();
+    if (averageCached.load(std::memory_order_acquire) && versions == cachedVersions.load(std::memory_order_acquire)) {
+        cacheCounts.hits++;
+        return cachedAverage.load(std::memory_order_relaxed);
+    }
+    cacheCounts.misses++;
     
     float totalGrade = 0.0f;
     for (const auto& course : courses) {
         totalGrade += course.calculateFinalGrade();
     }
     
-    return totalGrade / courses.size();
+    // Threads racing to fill a cold cache store the same average
+    float average = totalGrade / courses.size();
+    cachedAverage.store(average, std::memory_order_relaxed);
+    cachedVersions.store(versions, std::memory_order_release);
+    averageCached.store(true, std::memory_order_release);
+    return average;
+}
+
+// Versions only rise, so any grade change alters the sum
+uint64_t Student::courseVersions() const {
+    uint64_t versions = 0;
+    for (const auto& course : courses) {
+        versions += course.getVersion();
+    }
+    return versions;
+}
+
+unsigned long Student::getCacheHits() {
+    return finishedHits.load() + cacheCounts.hits;
+}
+
+unsigned long Student::getCacheMisses() {
+    return finishedMisses.load() + cacheCounts.misses;
 }
 
 
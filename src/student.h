@@ -3,20 +3,37 @@
 
 
 #include <string>
+#include <atomic>
 #include <vector>
 #include <memory>
 #include "course.h"
 #include "exceptions.h"
+#include "inlinevector.h"
 
 
 class Student {
 
+    public:
+        static const size_t MAX_COURSES = 10;
+
+        // Courses live inside the Student; loading does no heap allocation for them
+        typedef InlineVector<Course, MAX_COURSES> CourseList;
+
     private:
         std::string studentID;
         std::string studentName;
-        std::vector<Course> courses;
+        CourseList courses;
 
-        static const size_t MAX_COURSES = 10;
+        // Memoized overall average, invalidated when courses are added or
+        // removed, or when the courses' versions no longer add up to cachedVersions.
+        // Atomic, like Course's cache, so threads may share a const Student
+        mutable std::atomic<float> cachedAverage;
+        mutable std::atomic<bool> averageCached;
+        mutable std::atomic<uint64_t> cachedVersions;
+
+        void copyCache(const Student& other);
+
+        uint64_t courseVersions() const;
 
 
         bool studentIdCheck(const std::string& id) const;
@@ -32,24 +49,35 @@ class Student {
     Student(const Student& other);
     Student& operator=(const Student& other);
 
+    // Moves carry the strings and courses over without copying them
+    Student(Student&& other) noexcept;
+    Student& operator=(Student&& other) noexcept;
+
     ~Student() = default;
 
    
-    std::string getStudentID() const;
-    std::string getStudentName() const;
-    const std::vector<Course>& getCourses() const;
+    const std::string& getStudentID() const;
+    const std::string& getStudentName() const;
+    const CourseList& getCourses() const;
     size_t getCourseCount() const;
     
     void setStudentID(const std::string& id);
     void setStudentName(const std::string& name);
     
     bool addCourse(const Course& course);
+    bool addCourse(Course&& course);
+    bool addValidatedCourse(const Course& course);
+    bool addValidatedCourse(Course&& course);
     bool removeCourse(const std::string& courseCode);
     const Course* findCourse(const std::string& courseCode) const;
     Course* findCourse(const std::string& courseCode);
     bool hasCourse(const std::string& courseCode) const;
     
     float getOverallAverage() const;
+
+    // Overall average cache counters of this thread and of finished threads
+    static unsigned long getCacheHits();
+    static unsigned long getCacheMisses();
     
     bool operator==(const Student& other) const;
     bool operator!=(const Student& other) const;
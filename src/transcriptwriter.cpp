@@ -0,0 +1,245 @@
+#include "transcriptwriter.h"
+#include "exceptions.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+TranscriptWriter::TranscriptWriter(unsigned threads)
+    : threadCount(threads < 1 ? 1 : threads), written(0), seconds(0.0) {}
+
+static void appendGrade(std::string& buffer, float grade) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.1f", static_cast<double>(grade));
+    buffer.append(text, length);
+}
+
+// Byte-for-byte the same as toString() + getGradeSummary() + "\n"
+void TranscriptWriter::renderTranscript(const Student& student, std::string& buffer) {
+    const auto& courses = student.getCourses();
+
+    buffer += "Student ID: ";
+    buffer += student.getStudentID();
+    buffer += "\nName: ";
+    buffer += student.getStudentName();
+    buffer += "\nCourses: ";
+    buffer += std::to_string(courses.size());
+    buffer += '\n';
+
+    if (courses.empty()) {
+        buffer += "No courses enrolled\n";
+        return;
+    }
+
+    float average = student.getOverallAverage();
+    buffer += "Overall Average: ";
+    appendGrade(buffer, average);
+    buffer += "%\n";
+
+    for (const auto& course : courses) {
+        buffer += course.getCourseCode();
+        buffer += ": ";
+        appendGrade(buffer, course.calculateFinalGrade());
+        buffer += "%\n";
+    }
+    buffer += "Overall Average: ";
+    appendGrade(buffer, average);
+    buffer += "%\n";
+}
+
+std::string TranscriptWriter::shardPath(const std::string& root, const std::string& studentID) {
+    std::string first = studentID.size() >= 3 ? studentID.substr(0, 3) : "_";
+    std::string second = studentID.size() >= 6 ? studentID.substr(3, 3) : "_";
+    return root + "/" + first + "/" + second + "/" + studentID + ".txt";
+}
+
+std::vector<std::vector<const Student*>> TranscriptWriter::partition(const std::map<std::string, Student>& students) const {
+    std::vector<std::vector<const Student*>> parts(std::min<size_t>(threadCount, std::max<size_t>(students.size(), 1)));
+    size_t perPart = (students.size() + parts.size() - 1) / parts.size();
+    size_t index = 0;
+    for (const auto& [id, student] : students) {
+        parts[index / perPart].push_back(&student);
+        index++;
+    }
+    return parts;
+}
+
+bool TranscriptWriter::writeDirectory(const std::map<std::string, Student>& students, const std::string& root) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Create every shard directory up front so workers only create files
+    std::error_code error;
+    for (const auto& [id, student] : students) {
+        std::filesystem::create_directories(std::filesystem::path(shardPath(root, id)).parent_path(), error);
+        if (error) {
+            std::cerr << "Cannot create transcript directory under " << root << ": " << error.message() << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<std::vector<const Student*>> parts = partition(students);
+    std::vector<size_t> failures(parts.size(), 0);
+    std::vector<std::thread> workers;
+    for (size_t p = 0; p < parts.size(); ++p) {
+        workers.emplace_back([&, p]() {
+            std::string buffer;   // reused for every transcript in this partition
+            std::string path;
+            for (const Student* student : parts[p]) {
+                buffer.clear();
+                renderTranscript(*student, buffer);
+                path = shardPath(root, student->getStudentID());
+                FILE* file = std::fopen(path.c_str(), "wb");
+                if (!file || std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+                    failures[p]++;
+                }
+                if (file) {
+                    std::fclose(file);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    size_t failed = 0;
+    for (size_t f : failures) {
+        failed += f;
+    }
+    written = students.size() - failed;
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Wrote " << written << " transcripts to " << root << " in " << seconds << "s ("
+              << getTranscriptsPerSecond() << " transcripts/sec)" << std::endl;
+    if (failed > 0) {
+        std::cerr << "Warning: " << failed << " transcripts could not be written" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TranscriptWriter::writeArchive(const std::map<std::string, Student>& students, const std::string& filename) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Each worker renders its partition into one buffer and records the lengths
+    std::vector<std::vector<const Student*>> parts = partition(students);
+    std::vector<std::string> buffers(parts.size());
+    std::vector<std::vector<uint64_t>> lengths(parts.size());
+    std::vector<std::thread> workers;
+    for (size_t p = 0; p < parts.size(); ++p) {
+        workers.emplace_back([&, p]() {
+            lengths[p].reserve(parts[p].size());
+            for (const Student* student : parts[p]) {
+                size_t before = buffers[p].size();
+                renderTranscript(*student, buffers[p]);
+                lengths[p].push_back(buffers[p].size() - before);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    TranscriptArchiveHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TRANSCRIPT_MAGIC, sizeof(header.magic));
+    header.version = TRANSCRIPT_VERSION;
+    header.count = students.size();
+
+    std::vector<TranscriptIndexEntry> index;
+    index.reserve(students.size());
+    uint64_t offset = sizeof(header) + students.size() * sizeof(TranscriptIndexEntry);
+    for (size_t p = 0; p < parts.size(); ++p) {
+        for (size_t i = 0; i < parts[p].size(); ++i) {
+            TranscriptIndexEntry entry;
+            std::memset(&entry, 0, sizeof(entry));
+            std::strncpy(entry.studentID, parts[p][i]->getStudentID().c_str(), sizeof(entry.studentID) - 1);
+            entry.offset = offset;
+            entry.length = lengths[p][i];
+            offset += entry.length;
+            index.push_back(entry);
+        }
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw FileAccessException(filename);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TranscriptIndexEntry));
+    for (const auto& buffer : buffers) {
+        out.write(buffer.data(), buffer.size());
+    }
+    out.close();
+    if (!out) {
+        throw FileAccessException(filename);
+    }
+
+    written = students.size();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Wrote " << written << " transcripts to " << filename << " in " << seconds << "s ("
+              << getTranscriptsPerSecond() << " transcripts/sec)" << std::endl;
+    return true;
+}
+
+std::string TranscriptWriter::readArchiveEntry(const std::string& filename, const std::string& studentID) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        throw FileAccessException(filename);
+    }
+
+    TranscriptArchiveHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, TRANSCRIPT_MAGIC, sizeof(header.magic)) != 0) {
+        throw FileAccessException(filename);
+    }
+    in.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+    if (header.count > (fileSize - sizeof(header)) / sizeof(TranscriptIndexEntry)) {
+        throw TranscriptArchiveException(filename + ": index does not fit the file");
+    }
+
+    // Index entries are sorted by student ID
+    uint64_t low = 0, high = header.count;
+    TranscriptIndexEntry entry;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        in.seekg(sizeof(header) + mid * sizeof(entry));
+        in.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        if (!in) {
+            throw FileAccessException(filename);
+        }
+        int order = std::strncmp(entry.studentID, studentID.c_str(), sizeof(entry.studentID));
+        if (order == 0) {
+            // Checked before allocating, so a corrupt length cannot ask for more than the file holds
+            if (entry.length > fileSize || entry.offset > fileSize - entry.length) {
+                throw TranscriptArchiveException(filename + ": entry for " + studentID + " runs past the end");
+            }
+            std::string text(entry.length, '\0');
+            in.seekg(entry.offset);
+            in.read(&text[0], entry.length);
+            if (static_cast<uint64_t>(in.gcount()) != entry.length) {
+                throw TranscriptArchiveException(filename + ": short read for " + studentID);
+            }
+            return text;
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return "";
+}
+
+size_t TranscriptWriter::getWrittenCount() const {
+    return written;
+}
+
+double TranscriptWriter::getTranscriptsPerSecond() const {
+    return seconds > 0.0 ? written / seconds : 0.0;
+}
@@ -0,0 +1,59 @@
+#ifndef TRANSCRIPTWRITER_H
+#define TRANSCRIPTWRITER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "student.h"
+
+// Batch transcript generation: one transcript per student, the same text as
+// Student::toString() followed by getGradeSummary(), rendered in parallel.
+//
+// Directory mode shards files by ID, three digits per level, so no directory
+// holds more than 1000 entries:   <root>/123/456/123456789.txt
+// Archive mode writes one file with an index in front of the text:
+//   [TranscriptArchiveHeader][TranscriptIndexEntry x count][transcript bytes]
+
+const char TRANSCRIPT_MAGIC[8] = {'C', 'P', '3', '1', '7', 'T', 'R', 'N'};
+const uint32_t TRANSCRIPT_VERSION = 1;
+
+struct TranscriptArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t count;
+};
+
+struct TranscriptIndexEntry {
+    char studentID[16];
+    uint64_t offset;   // from the start of the file
+    uint64_t length;
+};
+
+class TranscriptWriter {
+    private:
+        unsigned threadCount;
+        size_t written;
+        double seconds;
+
+        std::vector<std::vector<const Student*>> partition(const std::map<std::string, Student>& students) const;
+
+    public:
+        TranscriptWriter(unsigned threads = 1);
+
+        // Appends a student's transcript to buffer without stream construction
+        static void renderTranscript(const Student& student, std::string& buffer);
+        static std::string shardPath(const std::string& root, const std::string& studentID);
+
+        bool writeDirectory(const std::map<std::string, Student>& students, const std::string& root);
+        bool writeArchive(const std::map<std::string, Student>& students, const std::string& filename);
+
+        // Reads one transcript back from an archive; empty if the ID is absent
+        static std::string readArchiveEntry(const std::string& filename, const std::string& studentID);
+
+        size_t getWrittenCount() const;
+        double getTranscriptsPerSecond() const;
+};
+
+#endif